@@ -0,0 +1,111 @@
+/**************************************************************************************************
+ *  File: batch.h
+ *  Desc: Sprite batching. Consecutive rects sharing a texture are submitted as one geometry draw.
+ **************************************************************************************************
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ * */
+
+
+#pragma once
+
+#ifndef FEATHER_BATCH_H
+#define FEATHER_BATCH_H
+
+#include <stdint.h>
+#include <intrinsics.h>
+#include <rect.h>
+
+/* 
+ *  @brief - snapshot of one rect, holding everything needed to draw it.
+ *
+ *  @sdlTexture     - texture of the rect.
+ *  @sdlSrc         - source rect of the current frame within the texture.
+ *  @uTexWidth      - width of the whole texture in pixels.
+ *  @uTexHeight     - height of the whole texture in pixels.
+ *  @sdlDst         - destination rect on the screen, already scaled.
+ *  @fRotation      - rotation around the destination's center in degrees.
+ *  @sdlColor       - tint of the texture.
+ * */
+typedef struct {
+    SDL_Texture *sdlTexture;
+    SDL_Rect sdlSrc;
+    uint32_t uTexWidth, uTexHeight;
+    SDL_FRect sdlDst;
+    float fRotation;
+    SDL_Color sdlColor;
+} tRenderCmd;
+
+/* 
+ *  @brief - CPU side vertex buffer for one run of rects sharing the same texture.
+ *
+ *  @sdlVerts       - four vertices per queued rect, already rotated and scaled.
+ *  @iIndices       - six indices per queued rect, two triangles for each quad.
+ *  @uQuads         - amount of rects queued within the current run.
+ *  @uCapacity      - amount of rects the buffers can hold without growing.
+ *  @sdlTexture     - texture of the current run. Pushing a rect with another texture flushes the run.
+ *  @uDrawCalls     - amount of geometry draws issued since the last frame began.
+ *
+ *  Buffers are kept between frames, so once they grow to fit the scene no more allocations happen.
+ * */
+typedef struct {
+    SDL_Vertex *sdlVerts;
+    int *iIndices;
+    uint32_t uQuads, uCapacity;
+    SDL_Texture *sdlTexture;
+    uint32_t uDrawCalls;
+} tRenderBatch;
+
+/* 
+ *  @brief - queues the rect into the batch, flushing the previous run if the texture differs.
+ *
+ *  @tBatch     - runtime's render batch.
+ *  @sdlRend    - renderer used for flushing.
+ *  @tRct       - rect to draw.
+ * */
+void vBatchPushRect(tRenderBatch *tBatch, SDL_Renderer *sdlRend, tRect *tRct) __attribute__((nonnull(1, 2, 3)));
+
+/* 
+ *  @brief - queues a recorded draw command, flushing the previous run if the texture differs.
+ * */
+void vBatchPushCmd(tRenderBatch *tBatch, SDL_Renderer *sdlRend, const tRenderCmd *tCmd) __attribute__((nonnull(1, 2, 3)));
+
+/* 
+ *  @brief - records the current state of the rect as a draw command.
+ * */
+tRenderCmd tBatchCmdFromRect(const tRect *tRct) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - draws one command without batching, the same way 'vDrawRect' draws a rect.
+ * */
+void vDrawRenderCmd(SDL_Renderer *sdlRend, const tRenderCmd *tCmd) __attribute__((nonnull(1, 2)));
+
+/* 
+ *  @brief - submits all queued rects with a single SDL_RenderGeometry call.
+ *
+ *  Must be called once after the last rect of the frame was pushed.
+ * */
+void vBatchFlush(tRenderBatch *tBatch, SDL_Renderer *sdlRend) __attribute__((nonnull(1, 2)));
+
+/* 
+ *  @brief - releases the vertex and index buffers of the batch.
+ * */
+void vBatchFree(tRenderBatch *tBatch) __attribute__((nonnull(1)));
+
+#endif
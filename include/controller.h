@@ -30,9 +30,12 @@
 #define FEATHER_CONTROLLER_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <intrinsics.h>
 #include <context2d.h>
 #include <tllist.h>
+#include <spatial.h>
+#include <rect.h>
 
 struct tController;
 typedef void (*fHandler)(void *tRun, struct tController *tCtrl);
@@ -43,8 +46,12 @@ typedef void (*fHandler)(void *tRun, struct tController *tCtrl);
  *
  *  @fHnd           - handler function for the specified event.
  *  @vUserData      - pointer to user data used within the handler.
- *  @sdlEvent       - specified event on which the handler function shall be invoked.
+ *  @sdlEventType   - specified event on which the handler function shall be invoked.
  *  @uControllerID  - identifier of this controller.
+ *  @sdlEvent       - last event of the batch, or the event currently dispatched by the inner handlers.
+ *  @sdlEvents      - all events of this type queued since the last invocation, oldest first.
+ *  @uEventCount    - amount of queued events.
+ *  @uEventCapacity - capacity of the event queue.
  *  @uDelay         - used by runtime to allow delays between controllers.
  *  @invoke         - inner flag used to identify invoked controllers.
  *
@@ -57,16 +64,112 @@ typedef struct {
     SDL_EventType sdlEventType;
     uint32_t uControllerID;
     SDL_Event sdlEvent;
+    SDL_Event *sdlEvents;
+    uint32_t uEventCount, uEventCapacity;
     uint32_t uDelay, uControllerLastCalled;
     bool invoke;
 } tController;
 
+/* 
+ *  @brief - queues the event for the next invocation of the controller.
+ *
+ *  If the controller is delayed, the events pile up and are delivered all at once, when the delay
+ *  passes. Returns false if the queue couldn't grow, in which case the event is dropped.
+ * */
+bool bControllerPushEvent(tController *tCtrl, const SDL_Event *sdlEvent) __attribute__((nonnull(1, 2)));
+
+/* 
+ *  @brief - drops all queued events of the controller, while keeping the memory.
+ * */
+void vControllerClearEvents(tController *tCtrl) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - frees the event queue of the controller.
+ * */
+void vControllerFreeEvents(tController *tCtrl) __attribute__((nonnull(1)));
+
 /* 
  *  @brief - list of controllers.
  * */
 typedef tll(tController) tControllerList;
-typedef struct { fHandler fHnd; SDL_Keycode sdlKey; } fKeyboardPair; 
-typedef tll(fKeyboardPair) fKeyboardHandlerPairList;
+
+/* 
+ *  @brief - all controllers listening on the same event type.
+ *
+ *  @sdlEventType   - event type of this bucket.
+ *  @tCtrls         - controllers within the scene's list. Their nodes never move while linked.
+ *  @uCount         - amount of controllers.
+ *  @uCapacity      - capacity of the controllers array.
+ *  @bUsed          - false for empty slots.
+ * */
+typedef struct {
+    uint32_t sdlEventType;
+    tController **tCtrls;
+    uint32_t uCount, uCapacity;
+    bool bUsed;
+} tControllerBucket;
+
+/* 
+ *  @brief - open addressing map from the event type to the controllers listening on it.
+ *
+ *  @tBuckets   - table of buckets. Buckets are emptied, but never removed.
+ *  @uBuckets   - amount of used buckets.
+ *  @uCapacity  - amount of slots. Always a power of two.
+ *
+ *  Zero initialized index is a valid empty one.
+ * */
+typedef struct {
+    tControllerBucket *tBuckets;
+    uint32_t uBuckets, uCapacity;
+} tControllerIndex;
+
+/* 
+ *  @brief - returns the bucket of the event type, or NULL if no controller ever listened on it.
+ * */
+tControllerBucket* tControllerIndexGet(tControllerIndex *tIndex, uint32_t sdlEventType) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - adds the controller to the bucket of it's event type.
+ * */
+void vControllerIndexAdd(tControllerIndex *tIndex, tController *tCtrl) __attribute__((nonnull(1, 2)));
+
+/* 
+ *  @brief - removes the controller from the bucket of it's event type.
+ * */
+void vControllerIndexRemove(tControllerIndex *tIndex, tController *tCtrl) __attribute__((nonnull(1, 2)));
+
+/* 
+ *  @brief - frees all memory held by the index.
+ * */
+void vControllerIndexFree(tControllerIndex *tIndex) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - all handler functions bound to the same key.
+ *
+ *  @sdlKey     - bound keycode.
+ *  @fHnds      - handler functions in the order they were bound. Called from the latest one.
+ *  @uCount     - amount of handler functions.
+ *  @uCapacity  - capacity of the handler array.
+ *  @bUsed      - false for empty slots.
+ * */
+typedef struct {
+    SDL_Keycode sdlKey;
+    fHandler *fHnds;
+    uint32_t uCount, uCapacity;
+    bool bUsed;
+} tKeyBinding;
+
+/* 
+ *  @brief - open addressing map from the keycode to it's bound handler functions.
+ *
+ *  @tSlots     - table of bindings.
+ *  @uUsed      - amount of bound keys.
+ *  @uCapacity  - amount of slots. Always a power of two.
+ * */
+typedef struct {
+    tKeyBinding *tSlots;
+    uint32_t uUsed, uCapacity;
+} tKeyBindingMap;
 
 /* 
  *  @brief - convenient controller for handling keyboard input.
@@ -81,7 +184,7 @@ typedef struct {
     } tCtrlPair;
 
     struct {
-        fKeyboardHandlerPairList sdlPressed, sdlReleased;
+        tKeyBindingMap sdlPressed, sdlReleased;
     } tKeybHndPair;
 
 } tKeyboardController;
@@ -93,6 +196,13 @@ typedef struct {
 
 void __vKeyboardControllerHandlerFn(void *vRun, tController *tCtrl);
 
+/* 
+ *  @brief - frees all key bindings of the keyboard controller.
+ *
+ *  Inner controllers are still owned by the scene and must be removed separately.
+ * */
+void vKeyboardControllerFree(tKeyboardController *tKeybCtrl) __attribute__((nonnull(1)));
+
 /* 
  *  @brief - returns true if the provided key was pressed at the time of function call.
  * */
@@ -103,11 +213,85 @@ typedef struct { fHandler fHnd; struct tRect *tRct; } fMouseBunch;
 typedef tll(fMouseKeyBunch) fMouseKeyBunchList;
 typedef tll(fMouseBunch) fMouseBunchList;
 
+/* 
+ *  @brief - mouse actions a handler can be bound to.
+ * */
+typedef enum { MOUSE_PRESS, MOUSE_RELEASE, MOUSE_HOVER, MOUSE_WHEEL } eMouseAction;
+
+/* 
+ *  @brief - one handler bound to a mouse target.
+ *
+ *  @vOwner     - mouse controller which bound the handler.
+ *  @fHnd       - handler function.
+ *  @eAction    - action triggering the handler.
+ *  @sdlButton  - button of press and release actions.
+ * */
+typedef struct {
+    void *vOwner;
+    fHandler fHnd;
+    eMouseAction eAction;
+    uint8_t sdlButton;
+} tMouseBinding;
+
+/* 
+ *  @brief - rect with at least one mouse handler bound to it.
+ *
+ *  @tRct       - the rect itself.
+ *  @uRectId    - handle of the rect, used to detect that the rect was removed from the scene.
+ *  @tBindings  - handlers bound to the rect.
+ *  @uCount     - amount of bindings.
+ *  @uCapacity  - capacity of the bindings array.
+ * */
+typedef struct {
+    tRect *tRct;
+    uint32_t uRectId;
+    tMouseBinding *tBindings;
+    uint32_t uCount, uCapacity;
+} tMouseTarget;
+
+/* 
+ *  @brief - scene wide spatial index over the rects, which have mouse handlers bound to them.
+ *
+ *  @tHash      - grid over the targets. Entry indices are also indices into the targets array.
+ *  @tTargets   - targets indexed by their spatial entry.
+ *  @uCapacity  - capacity of the targets array.
+ *
+ *  Bounds of the targets are refreshed once per frame, before the input is handled. Zero initialized
+ *  index is a valid empty one.
+ * */
+typedef struct {
+    tSpatialHash tHash;
+    tMouseTarget *tTargets;
+    uint32_t uCapacity;
+} tMouseIndex;
+
+/* 
+ *  @brief - moves all targets to the current bounds of their rects and drops the removed rects.
+ * */
+void vMouseIndexRefresh(tMouseIndex *tIndex, tRectPool *tPool) __attribute__((nonnull(1, 2)));
+
+/* 
+ *  @brief - returns the topmost target under the point having a handler of the owner for the action, or NULL.
+ *
+ *  Targets are compared by the priority of their rects and by their creation within the same priority,
+ *  so picking follows the render order. Only bindings of the owner are considered, so targets bound by
+ *  another mouse controller never hide the owner's targets beneath them.
+ * */
+tMouseTarget* tMouseIndexPick(tMouseIndex *tIndex, double x, double y, eMouseAction eAction, uint8_t sdlButton,
+                             const void *vOwner) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - frees all memory held by the index.
+ * */
+void vMouseIndexFree(tMouseIndex *tIndex) __attribute__((nonnull(1)));
+
 /* 
  *  @brief - defines a mouse controller that allows to perform something based on things clicker, or hovered on.
  *
  *  Allows to perform different tasks, when mouse is clicked or hovered on something defined within the 2DContext
- *  (usually rect).
+ *  (usually rect). Handlers without a rect are kept within the controller and called on every event, handlers
+ *  bound to a rect are kept within the scene's mouse index and called only if their rect is the topmost one under
+ *  the cursor.
  * */
 typedef struct {
 
@@ -120,6 +304,8 @@ typedef struct {
         fMouseBunchList sdlHover, sdlWheel;
     } tMouseHndBunch;
 
+    tMouseIndex *tIndex;
+
 } tMouseController;
 
 void __vMouseControllerHandlerFn(void *vRun, tController *tCtrl);
@@ -0,0 +1,100 @@
+/**************************************************************************************************
+ *  File: coroutine.h
+ *  Desc: Coroutine layers. The layer's body may wait for ticks, time or a condition in the middle
+ *  of it's code, while the runtime's scheduler keeps it parked until the wait is over.
+ **************************************************************************************************
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ * */
+
+#pragma once
+
+#ifndef FEATHER_COROUTINE_H
+#define FEATHER_COROUTINE_H
+
+#include <layer.h>
+#include <runtime.h>
+
+/* 
+ *  @brief - defines and appends a new coroutine layer to the scene.
+ *
+ *  The body is run as a stackless coroutine, so it can be suspended with the wait macros below and
+ *  continued from the same spot on a later tick. The continuation point is kept within the layer itself.
+ *  Local variables of the body are not preserved over waits, state shall be kept within 'anyLocal'.
+ *  The running runtime is provided as 'tRun'. Once the body ends, it will be started from the beginning
+ *  on the next tick. Waits can't be used within a 'switch' statement of the body.
+ *
+ *  FEATHER_COROUTINE(&Menu, 1, Blink, bool bOn, {
+ *      bOn = !bOn;
+ *      vFeatherCoWaitMs(500);
+ *  });
+ * */
+#define FEATHER_COROUTINE(sScene, iP, scName, anyLocal, ...)                    \
+    anyLocal;                                                                   \
+    __FEATHER_LAYER_DEFINE(sScene, iP, scName, 0, 0, {                          \
+        tRuntime *tRun = (tRuntime*)__tRun;                                     \
+        tLayer *__tCo = tRuntimeGetCurrentLayer(tRun);                          \
+        (void)tRun;                                                             \
+        switch (__tCo->uResume) {                                               \
+            case 0:                                                             \
+            __VA_ARGS__                                                         \
+        }                                                                       \
+        __tCo->uResume = 0;                                                     \
+    })
+
+/* Stores the continuation point and leaves the body, which continues right after it next time. */
+#define __vFeatherCoSuspend(fPark)                                              \
+    do { __tCo->uResume = __LINE__; fPark; return; case __LINE__:; } while (0)
+
+/* 
+ *  @brief - suspends the coroutine until the next tick.
+ * */
+#define vFeatherCoYield()                                                       \
+    __vFeatherCoSuspend((void)0)
+
+/* 
+ *  @brief - suspends the coroutine for the provided amount of update ticks.
+ * */
+#define vFeatherCoWaitTicks(uTicks)                                             \
+    __vFeatherCoSuspend(vFeatherParkThisLayerTicks(tRun, uTicks))
+
+/* 
+ *  @brief - suspends the coroutine for the provided amount of milliseconds.
+ * */
+#define vFeatherCoWaitMs(ms)                                                    \
+    __vFeatherCoSuspend(vFeatherParkThisLayerMs(tRun, ms))
+
+/* 
+ *  @brief - suspends the coroutine until the condition holds.
+ *
+ *  The condition is checked once per tick, since there is nothing that would signal it.
+ * */
+#define vFeatherCoWaitUntil(bCond)                                              \
+    do {                                                                        \
+        __tCo->uResume = __LINE__; case __LINE__:                               \
+        if (!(bCond)) return;                                                   \
+    } while (0)
+
+/* 
+ *  @brief - ends the coroutine and removes it's layer from the scene.
+ * */
+#define vFeatherCoExit()                                                        \
+    do { __tCo->iPriority = 0; __tCo->uResume = 0; return; } while (0)
+
+#endif
@@ -36,6 +36,9 @@
 #include <audio.h>
 #include <audio_fn.h>
 #include <font.h>
+#include <coroutine.h>
+#include <profile.h>
+#include <trace.h>
 
 int iFeatherMain(void) __attribute__((visibility("protected")));
 
@@ -29,11 +29,56 @@
 #ifndef FEATHER_FONT_H
 #define FEATHER_FONT_H
 
+#include <stdint.h>
+#include <stdbool.h>
 #include <tllist.h>
 #include <intrinsics.h>
 #include <context2d.h>
 
-typedef tll(char) sString;
+/* Strings up to this length, including the terminator, are stored within the string itself. */
+#define __FEATHER_STRING_INLINE 16
+
+/* 
+ *  @brief - growable contiguous UTF-8 string.
+ *
+ *  @uLength    - amount of bytes, without the terminator.
+ *  @uCapacity  - size of the heap buffer. Zero while the string is stored inline.
+ *  @sHeap      - heap buffer of long strings.
+ *  @sInline    - storage of short strings.
+ *
+ *  Data is always null terminated, so it can be used as a C string in place. Zero initialized string
+ *  is a valid empty one.
+ * */
+typedef struct {
+    uint32_t uLength, uCapacity;
+    union {
+        char *sHeap;
+        char sInline[__FEATHER_STRING_INLINE];
+    };
+} sString;
+
+/* 
+ *  @brief - returns the null terminated data of the string, without copying it.
+ * */
+static inline const char* sStringData(const sString *sStr) {
+    return sStr->uCapacity ? sStr->sHeap : sStr->sInline;
+}
+
+/* 
+ *  @brief - appends one byte to the string in amortized O(1). Returns false if out of memory.
+ * */
+bool bStringPush(sString *sStr, char cChar) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - removes the last byte of the string. Returns '\0' when the string is empty.
+ * */
+char cStringPop(sString *sStr) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - frees the heap buffer of the string, leaving an empty one.
+ * */
+void vStringFree(sString *sStr) __attribute__((nonnull(1)));
+
 #include <rect.h>
 
 /* 
@@ -43,10 +88,11 @@ typedef tll(char) sString;
  *  @uFontSize  - font size for display. It is different than scaling the rect manually, since it does not change
  *  the quality of the texture.
  *  @tRct       - underlying rect pointer.
- *  @sStr       - text string allocated on heap.
+ *  @sStr       - text string. Short texts are stored inline, longer ones within one heap buffer.
+ *  @sdlFont    - font of the text's glyph atlas. It is shared with all texts of the same font and size.
  *
  *  This structire is a wrapper over regular rect structure, which allows to easily modify the text, written to
- *  the screen.
+ *  the screen. Glyphs are rasterized once per font and size, so appending or popping a char is O(1).
  * */
 typedef struct {
     uint16_t uFontSize;
@@ -105,4 +151,11 @@ void vTextAppend(tRuntime *tRun, tText *tTxt, char *sSlice);
  * */
 void vChangeTextFont(tRuntime* tRun, tText* tTxt, const char* sNewFontPath, uint16_t uNewFontSize);
 
+/* 
+ *  @brief - removes the text's rect from the current scene and frees the text string.
+ *
+ *  The text shall be initialized again before any further use.
+ * */
+void vTextFree(tRuntime *tRun, tText *tTxt) __attribute__((nonnull(1, 2)));
+
 #endif
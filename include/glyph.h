@@ -0,0 +1,236 @@
+/**************************************************************************************************
+ *  File: glyph.h
+ *  Desc: Glyph atlases of the text renderer. Every font and size pair rasterizes each glyph once into
+ *  shared texture pages, and texts are drawn as runs of quads sampling these pages.
+ **************************************************************************************************
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ * */
+
+#pragma once
+
+#ifndef FEATHER_GLYPH_H
+#define FEATHER_GLYPH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <intrinsics.h>
+#include <texture.h>
+#include <batch.h>
+
+/* 
+ *  @brief - one rasterized glyph within the atlas.
+ *
+ *  @sdlSrc     - location of the glyph within it's page. Empty for glyphs without any pixels.
+ *  @uPage      - index of the page holding the glyph.
+ *  @iAdvance   - horizontal distance to the next glyph in pixels.
+ *  @bLoaded    - set once the glyph was rasterized.
+ * */
+typedef struct {
+    SDL_Rect sdlSrc;
+    uint16_t uPage;
+    int16_t iAdvance;
+    bool bLoaded;
+} tGlyph;
+
+/* 
+ *  @brief - glyph of a codepoint outside of the ASCII range.
+ * */
+typedef struct {
+    uint32_t uCodepoint;
+    tGlyph tGl;
+} tGlyphEntry;
+
+/* 
+ *  @brief - font file shared by all atlases opening the same path.
+ *
+ *  @sPath      - owned copy of the path, used as the cache key.
+ *  @vData      - content of the file.
+ *  @uSize      - size of the content in bytes.
+ *  @bMapped    - content is memory-mapped instead of read into a heap buffer.
+ *  @uRefCount  - amount of atlases using the file.
+ * */
+typedef struct {
+    char *sPath;
+    void *vData;
+    size_t uSize;
+    bool bMapped;
+    uint32_t uRefCount;
+} tFontFile;
+
+/* 
+ *  @brief - glyphs of one font and size pair, packed into texture pages.
+ *
+ *  @sPath      - owned copy of the font path.
+ *  @uSize      - point size of the font.
+ *  @tFile      - font file the font is opened from.
+ *  @sdlFont    - opened font, used to rasterize missing glyphs.
+ *  @iHeight    - line height of the font in pixels.
+ *  @sdlPages   - texture pages. Pointers to the textures stay valid while more pages are added.
+ *  @uPages     - amount of pages.
+ *  @uPenX      - horizontal position of the next glyph within the current shelf of the last page.
+ *  @uPenY      - top of the current shelf.
+ *  @uShelf     - height of the tallest glyph within the current shelf.
+ *  @tAscii     - glyphs of the ASCII range, indexed directly by the codepoint.
+ *  @tExtra     - open addressing table of all other glyphs. Codepoint zero marks an empty slot.
+ *  @uExtraCount    - amount of glyphs within the table.
+ *  @uExtraCapacity - amount of slots within the table. Always a power of two.
+ *  @uRefCount  - amount of texts using the atlas.
+ * */
+typedef struct {
+    char *sPath;
+    uint16_t uSize;
+    tFontFile *tFile;
+    TTF_Font *sdlFont;
+    int iHeight;
+
+    SDL_Texture **sdlPages;
+    uint32_t uPages;
+    uint32_t uPenX, uPenY, uShelf;
+
+    tGlyph tAscii[128];
+    tGlyphEntry *tExtra;
+    uint32_t uExtraCount, uExtraCapacity;
+    uint32_t uRefCount;
+} tGlyphAtlas;
+
+/* 
+ *  @brief - runtime owned set of glyph atlases.
+ *
+ *  @tAtlases   - all currently used atlases.
+ *  @uCount     - amount of atlases.
+ *  @uCapacity  - capacity of the atlas array.
+ *  @tFiles     - font files used by the atlases. Each file is loaded once, regardless of the sizes opened from it.
+ *  @uFileCount - amount of font files.
+ *  @uFileCapacity - capacity of the font file array.
+ *  @fDestroy   - called instead of SDL_DestroyTexture when set, so destruction of pages can be deferred.
+ *  @vDestroyCtx - context passed to 'fDestroy'.
+ *
+ *  Zero initialized cache is a valid empty one. Only a few fonts are used at once, so atlases are looked
+ *  up linearly.
+ * */
+typedef struct {
+    tGlyphAtlas **tAtlases;
+    uint32_t uCount, uCapacity;
+    tFontFile **tFiles;
+    uint32_t uFileCount, uFileCapacity;
+    fTextureDestroy fDestroy;
+    void *vDestroyCtx;
+} tGlyphCache;
+
+/* 
+ *  @brief - one byte of a text laid out as a quad.
+ *
+ *  @sdlPage    - page sampled by the quad, or NULL if nothing is drawn for this byte.
+ *  @sdlSrc     - location of the glyph within the page.
+ *  @fX         - pen position of the glyph within the text.
+ *  @uCodepoint - codepoint decoded so far. Only meaningful for the first byte of a character.
+ *  @uNeed      - amount of continuation bytes the character still waits for.
+ *  @uLead      - index of the quad holding the first byte of the character.
+ *
+ *  Multi-byte characters are drawn by the quad of their first byte, so removing the last byte of a
+ *  text is always O(1).
+ * */
+typedef struct {
+    SDL_Texture *sdlPage;
+    SDL_Rect sdlSrc;
+    float fX;
+    uint32_t uCodepoint;
+    uint8_t uNeed;
+    uint32_t uLead;
+} tGlyphQuad;
+
+/* 
+ *  @brief - laid out text of a rect.
+ *
+ *  @tAtlas     - atlas the glyphs are taken from.
+ *  @tQuads     - one quad per byte of the text.
+ *  @uCount     - amount of quads.
+ *  @uCapacity  - capacity of the quad array.
+ *  @fPenX      - width of the text laid out so far.
+ * */
+struct tGlyphRun {
+    tGlyphAtlas *tAtlas;
+    tGlyphQuad *tQuads;
+    uint32_t uCount, uCapacity;
+    float fPenX;
+};
+typedef struct tGlyphRun tGlyphRun;
+
+/* 
+ *  @brief - obtains the atlas of the font and size pair, opening the font on the first request.
+ *
+ *  Increments the reference count of the atlas. Returns NULL if the font can't be opened. The font file is
+ *  memory-mapped once and shared by all sizes, which are opened from it with TTF_OpenFontRW.
+ * */
+tGlyphAtlas* tGlyphAtlasAcquire(tGlyphCache *tCache, const char *sPath, uint16_t uSize) __attribute__((nonnull(1, 2)));
+
+/* 
+ *  @brief - drops one reference of the atlas. The last reference destroys it's pages and closes the font.
+ * */
+void vGlyphAtlasRelease(tGlyphCache *tCache, tGlyphAtlas *tAtlas) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - returns the glyph of the codepoint, rasterizing it into the atlas on the first request.
+ *
+ *  The renderer must be locked by the caller. Returns NULL if the glyph can't be rasterized.
+ * */
+const tGlyph* tGlyphAtlasGet(tGlyphAtlas *tAtlas, SDL_Renderer *sdlRend, uint32_t uCodepoint) __attribute__((nonnull(1, 2)));
+
+/* 
+ *  @brief - destroys all atlases regardless of their reference count.
+ * */
+void vGlyphCacheFree(tGlyphCache *tCache) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - creates an empty run drawing glyphs of the atlas. Returns NULL if out of memory.
+ * */
+tGlyphRun* tGlyphRunCreate(tGlyphAtlas *tAtlas);
+
+/* 
+ *  @brief - lays out one more byte of the text in O(1). The renderer must be locked by the caller.
+ *
+ *  UTF-8 sequences are decoded on the go, the character is drawn once it's last byte arrives.
+ * */
+bool bGlyphRunPush(tGlyphRun *tGr, SDL_Renderer *sdlRend, char cByte) __attribute__((nonnull(1, 2)));
+
+/* 
+ *  @brief - removes the last byte of the text in O(1).
+ * */
+void vGlyphRunPop(tGlyphRun *tGr) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - removes the whole text, keeping the quad array for the next layout.
+ * */
+void vGlyphRunClear(tGlyphRun *tGr) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - frees the run. The atlas reference is not released. NULL is ignored.
+ * */
+void vGlyphRunFree(tGlyphRun *tGr);
+
+/* 
+ *  @brief - records the i-th quad of the rect's glyph run as a draw command.
+ *
+ *  Quads are scaled with the rect and rotated around the center of the whole text.
+ * */
+tRenderCmd tGlyphRunCmd(const tRect *tRct, uint32_t i) __attribute__((nonnull(1)));
+
+#endif
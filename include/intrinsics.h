@@ -67,6 +67,98 @@ __PUSH_WINDOW_FLAGS
 #define FEATHER_MS_PER_UPDATE 10
 #endif
 
+#ifndef FEATHER_PRECISE_LOOP
+// If true, the main loop is timed with the high-resolution performance counter, limits the amount of updates per
+// frame and paces frames by sleeping first and spinning for the rest.
+#define FEATHER_PRECISE_LOOP 1
+#endif
+
+#ifndef FEATHER_MAX_UPDATE_STEPS
+// Maximum amount of update steps run within one frame. Time which is left over after a stall is dropped.
+#define FEATHER_MAX_UPDATE_STEPS 5
+#endif
+
+#ifndef FEATHER_SPIN_THRESHOLD_US
+// Part of the frame's remaining time, in microseconds, that is spent spinning instead of sleeping.
+#define FEATHER_SPIN_THRESHOLD_US 2000
+#endif
+
+#ifndef FEATHER_JOB_WORKERS
+// Amount of worker threads running concurrent layers. Zero uses one less than the amount of CPU cores.
+#define FEATHER_JOB_WORKERS 0
+#endif
+
+#ifndef FEATHER_HEADLESS
+// If true, runs without a display or audio device, advancing a virtual clock by one update per frame.
+#define FEATHER_HEADLESS 0
+#endif
+
+#ifndef FEATHER_HEADLESS_FRAMES
+// Amount of frames a headless run lasts. Zero runs until the application quits.
+#define FEATHER_HEADLESS_FRAMES 0
+#endif
+
+#ifndef FEATHER_RENDER_BATCHING
+// If true, rects sharing a texture are drawn with a single geometry call instead of one copy per rect. 
+// Requires SDL 2.0.18 or newer.
+#define FEATHER_RENDER_BATCHING 1
+#endif
+
+#ifndef FEATHER_RENDER_THREAD
+// If true, recorded frames are submitted by a dedicated render thread while the next frame is updated.
+#define FEATHER_RENDER_THREAD 0
+#endif
+
+#ifndef FEATHER_GLYPH_PAGE_SIZE
+// Width and height in pixels of one texture page of a glyph atlas.
+#define FEATHER_GLYPH_PAGE_SIZE 512
+#endif
+
+#ifndef FEATHER_PHYSICS_CELL_SIZE
+// Size of one spatial hash cell in game units. Should be around the size of a typical physical body.
+#define FEATHER_PHYSICS_CELL_SIZE 128
+#endif
+
+#ifndef FEATHER_LOG_ASYNC
+// If true, log messages are queued by the caller and written by a background logging thread.
+#define FEATHER_LOG_ASYNC 0
+#endif
+
+#ifndef FEATHER_LOG_ASYNC_CAPACITY
+// Amount of messages the asynchronous log queue can hold. Must be a power of two.
+#define FEATHER_LOG_ASYNC_CAPACITY 1024
+#endif
+
+#ifndef FEATHER_PROFILE
+// If true, phases, layers and controllers are timed into the profiler's sample rings.
+#define FEATHER_PROFILE 0
+#endif
+
+#ifndef FEATHER_PROFILE_SAMPLES
+// Amount of latest samples kept for each profiled scope.
+#define FEATHER_PROFILE_SAMPLES 512
+#endif
+
+#ifndef FEATHER_PROFILE_MAX_SCOPES
+// Maximum amount of profiled scopes. Must be a power of two.
+#define FEATHER_PROFILE_MAX_SCOPES 256
+#endif
+
+#ifndef FEATHER_TRACE
+// If true, profiled scopes, asset loads and scene swaps are written to a Chrome trace-event file.
+#define FEATHER_TRACE 0
+#endif
+
+#ifndef FEATHER_TRACE_FILE
+// Path of the written trace file. Unquoted, like the value CMake passes from .config.
+#define FEATHER_TRACE_FILE feather_trace.json
+#endif
+
+#ifndef FEATHER_TRACE_BUFFER_EVENTS
+// Amount of events each thread can record between two flushes.
+#define FEATHER_TRACE_BUFFER_EVENTS 65536
+#endif
+
 #define __FEATHER_SDL_DEFAULT SDL_INIT_VIDEO | SDL_INIT_EVENTS | SDL_INIT_AUDIO
 
 /* Combination of all required SDL subsystems for the program's need.  */
@@ -78,32 +170,47 @@ __PUSH_WINDOW_FLAGS
 
 /* All formats supported by SDL_image can be adjusted in Kconfig. */
 #ifndef FEATHER_TEXTURE_FORMAT
-#define FEATHER_TEXTURE_FORMAT 0
 
 #if FEATHER_TEXTURE_JPG
-#define FEATHER_TEXTURE_FORMAT FEATHER_TEXTURE_FORMAT | IMG_INIT_JPG
+#define __FEATHER_TEXTURE_JPG IMG_INIT_JPG
+#else
+#define __FEATHER_TEXTURE_JPG 0
 #endif
 
 #if FEATHER_TEXTURE_PNG
-#define FEATHER_TEXTURE_FORMAT FEATHER_TEXTURE_FORMAT | IMG_INIT_PNG
+#define __FEATHER_TEXTURE_PNG IMG_INIT_PNG
+#else
+#define __FEATHER_TEXTURE_PNG 0
 #endif
 
 #if FEATHER_TEXTURE_TIF
-#define FEATHER_TEXTURE_FORMAT FEATHER_TEXTURE_FORMAT | IMG_INIT_TIF
+#define __FEATHER_TEXTURE_TIF IMG_INIT_TIF
+#else
+#define __FEATHER_TEXTURE_TIF 0
 #endif
 
 #if FEATHER_TEXTURE_WEBP
-#define FEATHER_TEXTURE_FORMAT FEATHER_TEXTURE_FORMAT | IMG_INIT_WEBP
+#define __FEATHER_TEXTURE_WEBP IMG_INIT_WEBP
+#else
+#define __FEATHER_TEXTURE_WEBP 0
 #endif
 
 #if FEATHER_TEXTURE_JXL
-#define FEATHER_TEXTURE_FORMAT FEATHER_TEXTURE_FORMAT | IMG_INIT_JXL
+#define __FEATHER_TEXTURE_JXL IMG_INIT_JXL
+#else
+#define __FEATHER_TEXTURE_JXL 0
 #endif
 
 #if FEATHER_TEXTURE_AVIF
-#define FEATHER_TEXTURE_FORMAT FEATHER_TEXTURE_FORMAT | IMG_INIT_AVIF
+#define __FEATHER_TEXTURE_AVIF IMG_INIT_AVIF
+#else
+#define __FEATHER_TEXTURE_AVIF 0
 #endif
 
+// A macro can't be redefined in terms of itself, so the enabled formats are combined at once.
+#define FEATHER_TEXTURE_FORMAT (__FEATHER_TEXTURE_JPG | __FEATHER_TEXTURE_PNG | __FEATHER_TEXTURE_TIF | \
+                                __FEATHER_TEXTURE_WEBP | __FEATHER_TEXTURE_JXL | __FEATHER_TEXTURE_AVIF)
+
 #endif
 
 #define __FEATHER__WHITE__ (SDL_Color){255, 255, 255, 255}
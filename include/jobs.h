@@ -0,0 +1,162 @@
+/**************************************************************************************************
+ *  File: jobs.h
+ *  Desc: Work-stealing job system. Each worker thread owns a Chase-Lev deque, jobs of a dependency
+ *  graph are pushed to it once all their predecessors finished, and idle workers steal from others.
+ **************************************************************************************************
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ * */
+
+#pragma once
+
+#ifndef FEATHER_JOBS_H
+#define FEATHER_JOBS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <intrinsics.h>
+
+/* 
+ *  @brief - job function. The context is shared by all jobs of the graph.
+ * */
+typedef void (*fJobFn)(void *vCtx, void *vArg);
+
+struct tJobGraph;
+
+/* 
+ *  @brief - one job within the dependency graph.
+ *
+ *  @fFn            - job function.
+ *  @vArg           - argument of this job.
+ *  @tGraph         - graph owning the job.
+ *  @uSuccessors    - jobs waiting for this one.
+ *  @uSuccessorCount- amount of successors.
+ *  @uSuccessorCapacity - capacity of the successors array.
+ *  @uDependencies  - amount of jobs this one waits for.
+ *  @aPending       - amount of predecessors, which are still not finished within the current run.
+ * */
+typedef struct {
+    fJobFn fFn;
+    void *vArg;
+    struct tJobGraph *tGraph;
+    uint32_t *uSuccessors;
+    uint32_t uSuccessorCount, uSuccessorCapacity;
+    uint32_t uDependencies;
+    atomic_uint aPending;
+} tJobNode;
+
+/* 
+ *  @brief - directed acyclic graph of jobs, reusable between runs.
+ *
+ *  @tNodes     - jobs of the graph. Edges always go from a lower to a higher index.
+ *  @uCount     - amount of jobs.
+ *  @uCapacity  - capacity of the jobs array.
+ *  @vCtx       - context passed to all job functions.
+ *  @aRemaining - amount of jobs, which are not finished within the current run.
+ *
+ *  Zero initialized graph is a valid empty one.
+ * */
+typedef struct tJobGraph {
+    tJobNode *tNodes;
+    uint32_t uCount, uCapacity;
+    void *vCtx;
+    atomic_uint aRemaining;
+} tJobGraph;
+
+/* 
+ *  @brief - fixed size Chase-Lev deque. Only the owner pushes and pops from the bottom, others steal from the top.
+ * */
+#define __FEATHER_JOB_DEQUE_CAPACITY 1024
+
+typedef struct {
+    atomic_llong iTop, iBottom;
+    _Atomic(tJobNode*) tItems[__FEATHER_JOB_DEQUE_CAPACITY];
+} tJobDeque;
+
+/* 
+ *  @brief - pool of worker threads executing job graphs.
+ *
+ *  @tDeques    - one deque per thread. The first one belongs to the thread running the graph.
+ *  @sdlThreads - worker threads.
+ *  @uWorkers   - amount of worker threads.
+ *  @sdlWake    - posted once per worker when a graph starts.
+ *  @sdlReady   - posted for every queued job and once per thread when the graph finishes. Threads
+ *                without anything to take sleep on it.
+ *  @sdlDone    - posted by a worker for every wake-up, once it no longer looks at the graph.
+ *  @tActive    - graph which is currently run, or NULL between runs.
+ *  @bRunning   - cleared to stop the workers.
+ * */
+typedef struct tJobSystem {
+    tJobDeque *tDeques;
+    SDL_Thread **sdlThreads;
+    uint32_t uWorkers;
+    SDL_sem *sdlWake, *sdlReady, *sdlDone;
+    _Atomic(tJobGraph*) tActive;
+    atomic_bool bRunning;
+} tJobSystem;
+
+/* 
+ *  @brief - starts the worker threads. Zero workers picks one less than the amount of CPU cores.
+ *
+ *  Returns NULL if the system can't be created.
+ * */
+tJobSystem* tJobSystemCreate(uint32_t uWorkers);
+
+/* 
+ *  @brief - stops and joins all workers and frees the system. NULL is ignored.
+ * */
+void vJobSystemFree(tJobSystem *tJobs);
+
+/* 
+ *  @brief - adds a job to the graph. Returns it's index, or UINT32_MAX on failure.
+ * */
+uint32_t uJobGraphAdd(tJobGraph *tGraph, fJobFn fFn, void *vArg) __attribute__((nonnull(1, 2)));
+
+/* 
+ *  @brief - makes the job 'uAfter' wait until the job 'uBefore' finishes. Requires uBefore < uAfter.
+ *
+ *  Returns false if the dependency can't be stored, in which case the jobs must not be run concurrently.
+ * */
+bool bJobGraphDepend(tJobGraph *tGraph, uint32_t uBefore, uint32_t uAfter) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - runs all jobs of the graph and returns once all of them finished.
+ *
+ *  The calling thread executes jobs as well. Without a job system the graph is run serially in the
+ *  order the jobs were added, which always respects the dependencies.
+ * */
+void vJobGraphRun(tJobSystem *tJobs, tJobGraph *tGraph) __attribute__((nonnull(2)));
+
+/* 
+ *  @brief - removes the job added last, together with all dependencies on it. Ignored on an empty graph.
+ * */
+void vJobGraphPop(tJobGraph *tGraph) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - removes all jobs from the graph, while keeping the memory.
+ * */
+void vJobGraphClear(tJobGraph *tGraph) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - frees all memory held by the graph.
+ * */
+void vJobGraphFree(tJobGraph *tGraph) __attribute__((nonnull(1)));
+
+#endif
@@ -41,12 +41,19 @@
  *  values also have the highest priority.
  *  @sName      - name of the layer provided by user.
  *  @uLastSleep - used by runtime to implement sleeping layers.
+ *  @bParked    - set while the layer is parked within the scheduler. Parked layers are not run at all.
+ *  @uResume    - continuation point of coroutine layers. Zero starts the coroutine from the beginning.
+ *  @uReads     - resources read by the layer. See 'FEATHER_LAYER_RW'.
+ *  @uWrites    - resources written by the layer.
  * */
 typedef struct {
     void (*fRun)(void *tRun);
     int iPriority;
     char* sName;
     uint32_t uLastSleep;
+    bool bParked;
+    uint32_t uResume;
+    uint64_t uReads, uWrites;
 } tLayer;
 
 /* 
@@ -64,6 +71,11 @@ bool bLayerCmp(tLayer l1, tLayer l2);
  * */
 #define iPerformNTimes(N) -(int)N
 
+/* 
+ *  @brief - Returns a resource bit, used to declare what a layer reads or writes.
+ * */
+#define uFeatherResource(N) ((uint64_t)1 << (N))
+
 /* 
  *  @brief - defines and appends a new layer to the scene.
  *
@@ -72,6 +84,22 @@ bool bLayerCmp(tLayer l1, tLayer l2);
  * */
 #define FEATHER_LAYER(sScene, iP, scName, anyLocal, ...)    \
     anyLocal;                                               \
+    __FEATHER_LAYER_DEFINE(sScene, iP, scName, 0, 0, __VA_ARGS__)
+
+/* 
+ *  @brief - defines a layer, which declares the resources it reads and writes.
+ *
+ *  Resources are user defined bits (see 'uFeatherResource'). Consecutive layers declaring any resource
+ *  may run concurrently on the job system's workers, unless one of them writes what the other one reads
+ *  or writes. Layers without declarations still run alone and in their order, so they act as barriers.
+ *  Concurrent layers must not create or remove scene objects, since the scene itself is not thread safe.
+ * */
+#define FEATHER_LAYER_RW(sScene, iP, scName, uR, uW, anyLocal, ...) \
+    anyLocal;                                               \
+    __FEATHER_LAYER_DEFINE(sScene, iP, scName, uR, uW, __VA_ARGS__)
+
+/* Local declarations are not forwarded, since they may expand to unparenthesized commas. */
+#define __FEATHER_LAYER_DEFINE(sScene, iP, scName, uR, uW, ...) \
     void scName(void *__tRun) __VA_ARGS__;                  \
     __attribute__((constructor))                            \
     void scName##_constructor() {                           \
@@ -79,7 +107,11 @@ bool bLayerCmp(tLayer l1, tLayer l2);
             .fRun = scName,                                 \
             .iPriority = iP,                                \
             .sName = #scName,                               \
-            .uLastSleep = 0                                 \
+            .uLastSleep = 0,                                \
+            .bParked = false,                               \
+            .uResume = 0,                                   \
+            .uReads = (uR),                                 \
+            .uWrites = (uW)                                 \
         };                                                  \
         vSceneAppendLayer(sScene, layer);                   \
     }
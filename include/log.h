@@ -80,6 +80,15 @@ typedef void (*vLogFn)(tLogEvent *ev);
 // Six logging verbosity levels.
 enum { lTRACE, lDEBUG, lINFO, lWARN, lERROR, lFATAL };
 
+/* 
+ *  @brief - behavior of the asynchronous logger, when it's queue is full.
+ *
+ *  @lDROP  - message is dropped. The amount of dropped messages is reported later.
+ *  @lBLOCK - caller waits until the logging thread frees a slot.
+ *  @lSYNC  - message is written synchronously by the caller.
+ * */
+typedef enum { lDROP, lBLOCK, lSYNC } eLogFullPolicy;
+
 /* Definitions of useful macros for different logging levels. Those must be used in the actual code. */
 #define vFeatherLogTrace(...) __feather_log(lTRACE, __FILE__, __LINE__, __VA_ARGS__)
 #define vFeatherLogDebug(...) __feather_log(lDEBUG, __FILE__, __LINE__, __VA_ARGS__)
@@ -92,6 +101,9 @@ enum { lTRACE, lDEBUG, lINFO, lWARN, lERROR, lFATAL };
 #define vFeatherLogAddCallback(fn, udata, level) __feather_log_add_callback(fn, udata, level)
 #define vFeatherLogAddFile(fp, level) __feather_log_add_fp(fp, level)
 #define vFeatherLogLevelString(level) __feather_log_level_string(level)
+#define vFeatherLogSetFullPolicy(policy) __feather_log_set_full_policy(policy)
+#define vFeatherLogFlush() __feather_log_flush()
+#define vFeatherLogClose() __feather_log_close()
 
 /* 
  *  @brief - based on the provided level id, returns it's string representation. 
@@ -127,8 +139,31 @@ int __feather_log_add_callback(vLogFn vFn, void *vUserData, int iLevel);
  * */
 int __feather_log_add_fp(FILE *fFp, int iLevel);
 
+/* 
+ *  @brief - chooses what happens with messages when the asynchronous queue is full.
+ *
+ *  Only used when [FEATHER_LOG_ASYNC] is enabled. Defaults to dropping messages.
+ * */
+void __feather_log_set_full_policy(eLogFullPolicy ePolicy);
+/* 
+ *  @brief - waits until all queued messages are written.
+ *
+ *  Does nothing for the synchronous logger.
+ * */
+void __feather_log_flush(void);
+
+/* 
+ *  @brief - writes all queued messages and stops the logging thread.
+ *
+ *  Messages logged afterwards are written synchronously. Does nothing for the synchronous logger.
+ * */
+void __feather_log_close(void);
+
 /* 
  *  @brief - Performs the actual logging logic.
+ *
+ *  With [FEATHER_LOG_ASYNC] enabled, formats must be string literals, since only the pointer
+ *  to the format is queued. String arguments are copied.
  * */
 void __feather_log(int iLevel, const char *fout, int line, const char *cFmt, ...);
 
@@ -86,27 +86,134 @@ typedef enum {
     RIGHT = 0x8 
 } eGravityDirection;
 
+/* 
+ *  @brief - state of a colliding pair reported by the physics world.
+ * */
+typedef enum { COLLISION_ENTER, COLLISION_STAY, COLLISION_EXIT } eCollisionState;
+
+/* 
+ *  @brief - one collision event produced by a world step.
+ *
+ *  @uBodyA, uBodyB - bodies of the pair. uBodyA is always the smaller index.
+ *  @eState         - whether the pair started, kept or stopped overlapping.
+ * */
+typedef struct {
+    uint32_t uBodyA, uBodyB;
+    eCollisionState eState;
+} tCollisionEvent;
+
+/* 
+ *  @brief - handler invoked for each collision event of the body it was registered on.
+ *
+ *  @uBody      - body the handler was registered on.
+ *  @uOther     - the other body of the pair.
+ * */
+typedef void (*fCollisionHandler)(void *vUserData, uint32_t uBody, uint32_t uOther, eCollisionState eState);
+
+/* 
+ *  @brief - one cached overlapping pair.
+ *
+ *  @uKey   - both body indices, the smaller one in the upper half. Zero marks an empty slot.
+ *  @uStep  - last step in which the pair was seen overlapping.
+ * */
+typedef struct {
+    uint64_t uKey;
+    uint32_t uStep;
+} tCollisionPair;
+
+/* 
+ *  @brief - all physical bodies of one scene, stored as structure of arrays.
+ *
+ *  @tRects             - rects moved by the bodies. Positions are read from and written back to them. NULL for
+ *                        removed bodies, which are skipped by every step until their slot is reused.
+ *  @dX, dY, dW, dH     - bounds of the bodies, gathered from their rects on every step.
+ *  @eBodyTypes         - physical type of each body.
+ *  @uGroups            - colliders group of each body. Only bodies within the same group collide.
+ *  @uDelays            - minimal delay in milliseconds between two steps of the body.
+ *  @uLastSteps         - ticks of the last step of the body.
+ *  @uQueried           - world step in which the body last tested it's overlaps.
+ *  @uColliders         - entry of each body within the spatial hash.
+ *  @tForces            - additional forces supplied by the user to each body.
+ *  @uContacts          - amount of bodies currently overlapping each body.
+ *  @fHandlers          - optional collision handler of each body.
+ *  @vHandlersData      - user data passed to the handler of each body.
+ *  @uCount             - amount of bodies.
+ *  @uCapacity          - amount of bodies the arrays can hold without growing.
+ *  @uDead              - bodies removed since the last step, whose pairs are not dropped yet.
+ *  @uDeadCount         - amount of bodies within uDead.
+ *  @uFree              - stack of removed bodies without any pairs, reused before the arrays grow.
+ *  @uFreeCount         - amount of bodies within uFree.
+ *  @tSpatial           - broadphase of the whole world.
+ *  @tPairs             - open addressing cache of all overlapping pairs.
+ *  @uPairs             - amount of cached pairs.
+ *  @uPairCapacity      - amount of pair slots. Always a power of two.
+ *  @tEvents            - collision events of the last step.
+ *  @uEvents            - amount of events of the last step.
+ *  @uEventCapacity     - capacity of the event queue.
+ *  @uStep              - counter of world steps.
+ *
+ *  The world is stepped once per fixed update: forces are integrated, all bounds are synced into
+ *  the spatial hash, then each body is tested only against the candidates sharing it's cells.
+ *  Overlapping pairs are diffed against the pair cache of the previous steps. All storage is
+ *  reused between steps, so there are no allocations in steady state.
+ * */
+typedef struct tPhysicsWorld {
+    tRect **tRects;
+    double *dX, *dY, *dW, *dH;
+    ePhysicalBodyType *eBodyTypes;
+    uint32_t *uGroups;
+    uint32_t *uDelays, *uLastSteps, *uQueried;
+    uint32_t *uColliders;
+    tForcesList *tForces;
+    uint32_t *uContacts;
+    fCollisionHandler *fHandlers;
+    void **vHandlersData;
+    uint32_t uCount, uCapacity;
+    uint32_t *uDead, uDeadCount;
+    uint32_t *uFree, uFreeCount;
+
+    tSpatialHash tSpatial;
+
+    tCollisionPair *tPairs;
+    uint32_t uPairs, uPairCapacity;
+
+    tCollisionEvent *tEvents;
+    uint32_t uEvents, uEventCapacity;
+    uint32_t uStep;
+} tPhysicsWorld;
+
 /* 
  *  @brief - simple physics controller that can be used to interact within the entities.
  *
- *  @uCtrlId            - ID value of the underlying controller.
- *  @tRct               - pointer to the rect entity, which will be affected by physics.
- *  @eBodyType          - physical type of this body. This defines a lot about the behavior of this entity
- *  @uCollidersGroup    - group in which this entity appears. Only entitties within the same group collide.
- *  @tAdditionalForces  - additional forces supplied by user.
- *  @uDelay             - delay in milliseconds, which prevents this controller from spamming too much.
+ *  @tWorld     - world owning the body. It is the physics world of the scene, the body was created in.
+ *  @uBody      - index of the body within the world.
  *
+ *  Controller is a plain handle, so it can be freely copied and doesn't have to outlive the body.
  * */
 typedef struct {
-    uint32_t uCtrlId, uDelay, uCollidersGroup;
-    tRect *tRct;
-    ePhysicalBodyType eBodyType;
-    eGravityDirection eGravityDir;
-    tForcesList tAdditionalForces;
-    tColliders lCurrentlyCollides;
+    tPhysicsWorld *tWorld;
+    uint32_t uBody;
 } tPhysController;
 
-void __vPhysicsControllerInternal(void *vRun, tController *tCtrl);
+/* 
+ *  @brief - steps every body within the world once.
+ *
+ *  Called by the runtime once per fixed update, before the controllers are handled.
+ * */
+void vPhysicsWorldStep(tPhysicsWorld *tWorld) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - frees the world and all of it's bodies.
+ * */
+void vPhysicsWorldFree(tPhysicsWorld *tWorld);
+
+/* 
+ *  @brief - removes the body of the rect from the world. Ignored if the world is NULL or the rect has no body.
+ *
+ *  Must be called before the rect is destroyed. Indices of other bodies stay valid, and pairs of the removed
+ *  body are reported as exited on the next step. After that step the index may be reused by a new body.
+ * */
+void vPhysicsRemove(tPhysicsWorld *tWorld, tRect *tRct) __attribute__((nonnull(2)));
 
 /* 
  *  @brief - handles the physical layer of the application for the chosen entity.
@@ -120,6 +227,11 @@ void __vPhysicsControllerInternal(void *vRun, tController *tCtrl);
 void vPhysicsInit(tRuntime *tRun, tPhysController *tPhys, tRect *tRct, ePhysicalBodyType eBodyType, uint32_t uCollidersGroup) \
     __attribute__((nonnull(1, 2, 3)));
 
+/* 
+ *  @brief - changes the physical type of the body.
+ * */
+void vPhysicsSetBodyType(tPhysController *tPhys, ePhysicalBodyType eBodyType) __attribute__((nonnull(1)));
+
 
 /* 
  *  @brief - allows to set the delay between physics controller calls.
@@ -145,4 +257,23 @@ void vPhysicsApplyForce(tPhysController *tPhys, tForce tF) __attribute__((nonnul
  * */
 bool bPhysicsCurrentlyCollides(tPhysController *tPhys);
 
+/* 
+ *  @brief - registers a handler receiving enter, stay and exit events of the body.
+ *
+ *  @tPhys      - physics controller of the body.
+ *  @fHnd       - handler to invoke after each step. NULL removes the handler.
+ *  @vUserData  - pointer passed to the handler.
+ * */
+void vPhysicsOnCollision(tPhysController *tPhys, fCollisionHandler fHnd, void *vUserData) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - gives the collision events produced by the last step of the world.
+ *
+ *  @tWorld     - physics world, i.e the one of the controller.
+ *  @tEvents    - receives the event queue. Valid until the next step.
+ *
+ *  Returns the amount of events.
+ * */
+uint32_t uPhysicsCollisionEvents(tPhysicsWorld *tWorld, const tCollisionEvent **tEvents) __attribute__((nonnull(2)));
+
 #endif
@@ -0,0 +1,136 @@
+/**************************************************************************************************
+ *  File: profile.h
+ *  Desc: Frame phase profiler. Durations of the input, update and render phases, as well as of each
+ *  layer and controller, are kept in fixed-size rings and summarized on request.
+ **************************************************************************************************
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ * */
+
+#pragma once
+
+#ifndef FEATHER_PROFILE_H
+#define FEATHER_PROFILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <intrinsics.h>
+
+/* 
+ *  @brief - kind of the profiled scope. Together with the key it identifies the scope.
+ * */
+typedef enum { PROFILE_PHASE, PROFILE_LAYER, PROFILE_CONTROLLER } eProfileKind;
+
+/* 
+ *  @brief - keys of the engine's phase scopes. Layers are keyed by their name, controllers by their ID.
+ * */
+typedef enum { PHASE_INPUT, PHASE_UPDATE, PHASE_PHYSICS, PHASE_RENDER } eProfilePhase;
+
+/* 
+ *  @brief - one profiled scope with it's latest samples.
+ *
+ *  @eKind      - kind of the scope.
+ *  @uKey       - identifier of the scope within it's kind.
+ *  @sName      - name shown within the statistics.
+ *  @uSamples   - ring of the latest durations in high-resolution ticks. NULL without FEATHER_PROFILE.
+ *  @uHead      - slot the next sample is written to.
+ *  @uCount     - amount of valid samples, at most FEATHER_PROFILE_SAMPLES.
+ *  @bUsed      - true if the slot holds a scope.
+ * */
+typedef struct {
+    eProfileKind eKind;
+    uintptr_t uKey;
+    char sName[48];
+    uint64_t *uSamples;
+    uint32_t uHead, uCount;
+    bool bUsed;
+} tProfileScope;
+
+/* 
+ *  @brief - rolling statistics of one scope over it's latest samples. All durations are in milliseconds.
+ * */
+typedef struct {
+    const char *sName;
+    uint32_t uSamples;
+    double dMin, dAvg, dP95, dP99, dMax;
+} tProfileStats;
+
+#if FEATHER_PROFILE || FEATHER_TRACE
+/* 
+ *  @brief - starts timing a scope by declaring the start timestamp.
+ * */
+#define FEATHER_PROFILE_BEGIN(uStart) \
+    uint64_t uStart = SDL_GetPerformanceCounter()
+
+/* 
+ *  @brief - records the time elapsed since 'FEATHER_PROFILE_BEGIN' within the scope.
+ *
+ *  The name is formatted only once, when the scope is seen for the first time. With FEATHER_TRACE the
+ *  scope is added to the trace's timeline as well.
+ * */
+#define FEATHER_PROFILE_END(uStart, eKind, uKey, ...) \
+    vProfileScopeEnd(tProfileScopeGet(eKind, (uintptr_t)(uKey), __VA_ARGS__), uStart, SDL_GetPerformanceCounter())
+#else
+#define FEATHER_PROFILE_BEGIN(uStart)
+#define FEATHER_PROFILE_END(uStart, eKind, uKey, ...)
+#endif
+
+/* 
+ *  @brief - returns the scope, registering it on the first call.
+ *
+ *  Returns NULL once FEATHER_PROFILE_MAX_SCOPES scopes exist.
+ * */
+tProfileScope* tProfileScopeGet(eProfileKind eKind, uintptr_t uKey, const char *sFmt, ...) __attribute__((format(printf, 3, 4)));
+
+/* 
+ *  @brief - adds one duration in high-resolution ticks to the scope, overwriting the oldest one. NULL is ignored.
+ * */
+void vProfileRecord(tProfileScope *tScope, uint64_t uTicks);
+
+/* 
+ *  @brief - finishes one timed run of the scope, feeding the profiler and the trace. NULL is ignored.
+ * */
+void vProfileScopeEnd(tProfileScope *tScope, uint64_t uStart, uint64_t uEnd);
+
+/* 
+ *  @brief - returns the amount of registered scopes.
+ * */
+uint32_t uProfileScopeCount(void);
+
+/* 
+ *  @brief - computes statistics of the i-th registered scope. Returns false if there is no such scope.
+ * */
+bool bProfileStatsAt(uint32_t i, tProfileStats *tStats) __attribute__((nonnull(2)));
+
+/* 
+ *  @brief - computes statistics of the scope with the provided name. Returns false if there is no such scope.
+ * */
+bool bProfileStats(const char *sName, tProfileStats *tStats) __attribute__((nonnull(1, 2)));
+
+/* 
+ *  @brief - logs statistics of all scopes, which have samples.
+ * */
+void vProfileLogStats(void);
+
+/* 
+ *  @brief - drops all scopes and their samples.
+ * */
+void vProfileReset(void);
+
+#endif
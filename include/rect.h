@@ -30,9 +30,12 @@
 
 #include <tllist.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <context2d.h>
 #include <intrinsics.h>
 
+struct tGlyphRun;
+
 /* 
  *  @brief - helper framing structure to indexate the surface of the rect.
  * */
@@ -56,12 +59,19 @@ typedef struct {
  *  @brief - Rect data type.
  *
  *  @sTexturePath   - path to the texture for the rectangle. A solid color will be used if the texture is NULL.
+ *  @sdlColor       - color modulation applied while drawing. Solid color rects are drawn entirely in it.
  *  @tCtx           - 2D context of the rectangle. Mutating it is a proper way of changing it's location, size and rotation. 
  *  @uPriority      - priority for rendering. Higher priorities will be rendered on top of lower ones. 
- *  @sdlRect        - underlying pointer to SDL rect representation.
+ *  @uTexWidth      - cached width of the whole texture in pixels.
+ *  @uTexHeight     - cached height of the whole texture in pixels.
+ *  @uColumns       - amount of frames within one row of the texture.
+ *  @sdlSrc         - source rect of the current frame within the texture.
  *  @uAnimationID   - currently running animation.
+ *  @uRectId        - generational handle of the rect within the scene's rect pool.
+ *  @uSeq           - creation sequence within the pool, orders rects of the same priority.
  *  @tAnims         - animations appended to the rect.
  *  @tFr            - frame buffer.
+ *  @tGlyphs        - laid out glyphs of text rects, drawn instead of the texture. NULL for all other rects.
  *
  *  Rects are main boxes for holding information about something that shall be drawn on the screen, 
  *  it's boundaries and coordinates.
@@ -69,22 +79,117 @@ typedef struct {
 typedef struct {
     char* sTexturePath;
     uintptr_t idTextureID;
+    SDL_Color sdlColor;
     tContext2D tCtx;
     uint16_t uPriority;   
-    SDL_Rect *sdlRect;
     tFrame tFr;
+    uint32_t uTexWidth, uTexHeight;
+    uint32_t uColumns;
+    SDL_Rect sdlSrc;
 
     uint16_t uAnimationId;
     uint32_t uRectId;
+    uint32_t uSeq;
     tll(tAnimation) tAnims;
+    struct tGlyphRun *tGlyphs;
 } tRect;
 
-static uint32_t uRectIDIncrementer = 0;
+/* Rects are allocated in fixed pages, so pointers to them stay valid while the pool grows. */
+#define __FEATHER_RECT_PAGE_BITS 8
+#define __FEATHER_RECT_PAGE_SIZE (1u << __FEATHER_RECT_PAGE_BITS)
+
+/* Handles keep the slot in the lower bits and the slot's generation in the upper ones. */
+#define __FEATHER_RECT_SLOT_BITS 22
+#define __FEATHER_RECT_SLOT_MASK ((1u << __FEATHER_RECT_SLOT_BITS) - 1)
+#define __FEATHER_RECT_HANDLE(uSlot, uGen) (((uint32_t)(uGen) << __FEATHER_RECT_SLOT_BITS) | (uSlot))
+#define FEATHER_RECT_INVALID UINT32_MAX
+
+/* Sort keys hold the priority, the creation sequence and the slot, so sequences get the bits left over. */
+#define __FEATHER_RECT_SEQ_BITS (48 - __FEATHER_RECT_SLOT_BITS)
+
+/* 
+ *  @brief - dense storage of all drawable rectangles within a scene.
+ *
+ *  @tPages         - fixed size pages of rect slots.
+ *  @uGenerations   - current generation of every slot. Bumped whenever a slot is freed.
+ *  @uPages         - amount of allocated pages.
+ *  @uSlots         - amount of slots that were ever handed out.
+ *  @uFree          - stack of freed slots, reused before new slots are taken.
+ *  @uFreeCount     - amount of slots within the free stack.
+ *  @uOrder         - slots of all live rects in rendering order. New rects are appended in O(1).
+ *  @uSortKeys      - scratch buffer of twice the capacity, used by the per frame radix sort.
+ *  @uCount         - amount of live rects.
+ *  @uCapacity      - capacity of the free stack and the order array.
+ *  @uNextSeq       - creation sequence given to the next inserted rect.
+ *
+ *  Zero initialized pool is a valid empty pool.
+ * */
+typedef struct {
+    tRect **tPages;
+    uint16_t *uGenerations;
+    uint32_t uPages, uSlots;
+
+    uint32_t *uFree;
+    uint32_t uFreeCount;
+
+    uint32_t *uOrder;
+    uint64_t *uSortKeys;
+    uint32_t uCount, uCapacity;
+    uint32_t uNextSeq;
+} tRectPool;
+
+/* 
+ *  @brief - returns the rect stored within the provided slot.
+ * */
+static inline tRect* __tRectPoolSlot(tRectPool *tPool, uint32_t uSlot) {
+    return &tPool->tPages[uSlot >> __FEATHER_RECT_PAGE_BITS][uSlot & (__FEATHER_RECT_PAGE_SIZE - 1)];
+}
+
+/* 
+ *  @brief - returns the i-th rect in rendering order.
+ * */
+static inline tRect* tRectPoolAt(tRectPool *tPool, uint32_t i) {
+    return __tRectPoolSlot(tPool, tPool->uOrder[i]);
+}
+
+/* 
+ *  @brief - moves the rect into the pool and assigns it a new handle.
+ *
+ *  Returns a pointer to the stored rect, which stays valid until the rect is removed.
+ * */
+tRect* tRectPoolInsert(tRectPool *tPool, tRect tRct) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - resolves the handle to the rect in O(1). Returns NULL for stale or unknown handles.
+ * */
+tRect* tRectPoolGet(tRectPool *tPool, uint32_t uRectId) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - removes the rect from the pool. Returns false if the rect is not within the pool.
+ *
+ *  The rect's slot is reused by later insertions, with a new generation.
+ * */
+bool bRectPoolRemove(tRectPool *tPool, tRect *tRct) __attribute__((nonnull(1, 2)));
+
+/* 
+ *  @brief - sorts the rendering order by priority, and by creation within the same priority.
+ *
+ *  Called once per frame before rendering. Runs in linear time and does nothing if the order is
+ *  already sorted.
+ * */
+void vRectPoolSort(tRectPool *tPool) __attribute__((nonnull(1)));
 
 /* 
- *  @brief - List of drawable rectangles.
+ *  @brief - frees all pool storage together with the animations of live rects.
+ * */
+void vRectPoolFree(tRectPool *tPool) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - recomputes the cached source rect from the texture size and the current frame.
+ *
+ *  Must be called whenever the texture or the frame of the rect changes.
  * */
-typedef tll(tRect) tRectList;
+void __vRectRefreshFrame(tRect *tRct) __attribute__((nonnull(1)));
 
 /* 
  *  @brief - choose the frame to draw in the next render cycle.
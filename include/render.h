@@ -0,0 +1,136 @@
+/**************************************************************************************************
+ *  File: render.h
+ *  Desc: Render thread. The update phase records the rects of each frame into a command list, which a
+ *  dedicated thread submits to the renderer while the next frame is computed.
+ **************************************************************************************************
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ * */
+
+#pragma once
+
+#ifndef FEATHER_RENDER_H
+#define FEATHER_RENDER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <intrinsics.h>
+#include <batch.h>
+
+/* 
+ *  @brief - commands of one frame, together with textures that may be destroyed after it.
+ *
+ *  @tCmds              - draw commands in the order they are submitted.
+ *  @uCount             - amount of recorded commands.
+ *  @uCapacity          - amount of commands the list can hold without growing.
+ *  @sdlGraveyard       - textures released while this frame was recorded.
+ *  @uGraveCount        - amount of released textures.
+ *  @uGraveCapacity     - amount of textures the graveyard can hold without growing.
+ * */
+typedef struct {
+    tRenderCmd *tCmds;
+    uint32_t uCount, uCapacity;
+    SDL_Texture **sdlGraveyard;
+    uint32_t uGraveCount, uGraveCapacity;
+} tRenderList;
+
+/* 
+ *  @brief - thread submitting recorded frames to the renderer.
+ *
+ *  @tLists         - double buffered command lists. One is recorded, while the other one is submitted.
+ *  @uRecord        - index of the list recorded by the update phase.
+ *  @sdlThread      - the render thread itself.
+ *  @sdlLock        - guards the swap of the lists.
+ *  @sdlSubmitted   - signaled by the render thread once a frame is presented.
+ *  @sdlQueued      - signaled by the update phase once a frame is recorded.
+ *  @bPending       - true while the list not being recorded waits for, or is in, submission.
+ *  @bRunning       - cleared to stop the thread.
+ *  @fCall          - closure handed over by 'vRenderThreadCall', or NULL if none is waiting.
+ *  @vCallArg       - argument of the handed over closure.
+ *  @uCallsQueued   - amount of closures ever handed over.
+ *  @uCallsDone     - amount of closures the render thread has returned from.
+ *  @sdlCalled      - signaled by the render thread once a closure returns.
+ *  @sdlRenderer    - renderer the frames are drawn with. Created by, and only ever used on, the render thread.
+ *  @tBatch         - sprite batch owned by the render thread.
+ *
+ *  Swapping the lists is the only point where both threads wait for each other. Contexts of some backends,
+ *  like OpenGL, can only be current on one thread, so all other renderer calls are run on the render thread
+ *  by 'vRenderThreadCall'. Textures must not be destroyed while they may still be drawn, so they are passed
+ *  to 'vRenderThreadDestroyTexture', which destroys them once the frame that released them is submitted.
+ * */
+typedef struct {
+    tRenderList tLists[2];
+    uint32_t uRecord;
+    SDL_Thread *sdlThread;
+    SDL_mutex *sdlLock;
+    SDL_cond *sdlSubmitted, *sdlQueued;
+    bool bPending, bRunning;
+    fClosure fCall;
+    void *vCallArg;
+    uint64_t uCallsQueued, uCallsDone;
+    SDL_cond *sdlCalled;
+    SDL_Renderer *sdlRenderer;
+    tRenderBatch tBatch;
+} tRenderThread;
+
+/* 
+ *  @brief - starts the render thread and creates the window's renderer on it.
+ *
+ *  @sdlWindow  - window the renderer draws to.
+ *  @uFlags     - SDL_RendererFlags passed to SDL_CreateRenderer.
+ *
+ *  Returns NULL if the thread or the renderer can't be created, in which case frames shall be rendered directly.
+ * */
+tRenderThread* tRenderThreadCreate(SDL_Window *sdlWindow, uint32_t uFlags) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - records the current state of the rect into the frame.
+ * */
+void vRenderThreadPushRect(tRenderThread *tRender, tRect *tRct) __attribute__((nonnull(1, 2)));
+
+/* 
+ *  @brief - hands the recorded frame over to the render thread.
+ *
+ *  Waits until the previous frame is presented, so the update phase is at most one frame ahead.
+ * */
+void vRenderThreadSubmit(tRenderThread *tRender) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - destroys the texture once no submitted frame can reference it anymore.
+ *
+ *  Without a render thread the texture is destroyed right away.
+ * */
+void vRenderThreadDestroyTexture(tRenderThread *tRender, SDL_Texture *sdlTexture);
+
+/* 
+ *  @brief - runs the closure on the render thread and waits for it to return.
+ *
+ *  Every call using the renderer, like texture uploads, shall be made through this function. Calls wait for
+ *  the frame in submission to be presented. Without a render thread the closure is called right away.
+ * */
+void vRenderThreadCall(tRenderThread *tRender, fClosure fCall, void *vArg) __attribute__((nonnull(2)));
+
+/* 
+ *  @brief - presents the last frame, stops the thread and destroys all released textures. NULL is ignored.
+ *
+ *  The renderer itself is kept, like the one created without a render thread.
+ * */
+void vRenderThreadFree(tRenderThread *tRender);
+
+#endif
@@ -42,6 +42,11 @@
 #include <scene.h>
 #include <intrinsics.h>
 #include <rect.h>
+#include <texture.h>
+#include <glyph.h>
+#include <batch.h>
+#include <render.h>
+#include <jobs.h>
 
 /* 
  *  @brief - engine's runtime datatype structure.
@@ -52,6 +57,17 @@
  *  @sScene             - currently used scene. 
  *  @sdlRenderer        - SDL renderer for drawing rects.
  *  @tMixer             - runtime sound mixer.
+ *  @tTextures          - shared texture cache used by all rects.
+ *  @tGlyphs            - glyph atlases shared by all texts of the same font and size.
+ *  @tBatch             - sprite batch used by the render phase, if batching is enabled.
+ *  @tRender            - render thread submitting recorded frames, or NULL if frames are drawn directly.
+ *  @tJobs              - worker threads running concurrent layers. Started by the first such layer.
+ *  @tLayerGraph        - dependency graph of concurrent layers, rebuilt on each update.
+ *  @bHeadless          - runs without a display or an audio device on a virtual clock. Can be enabled within
+ *                        'vRuntimeConfig', which restarts SDL's display and audio with the dummy drivers.
+ *  @uHeadlessFrames    - amount of frames a headless run lasts. Zero runs until the application quits.
+ *  @dAlpha             - fraction of the update step elapsed since the last update, within [0, 1). The render
+ *                        phase may use it to interpolate between the previous and the current state.
  *
  *  Defines the current active scene, processes the input, schedules all layers within that scene and
  *  renders the graphics.
@@ -63,6 +79,15 @@ typedef struct {
     SDL_Window *wRunWindow;
     SDL_Renderer *sdlRenderer;
     tRuntimeMixer tMixer;
+    tTextureCache tTextures;
+    tGlyphCache tGlyphs;
+    tRenderBatch tBatch;
+    tRenderThread *tRender;
+    tJobSystem *tJobs;
+    tJobGraph tLayerGraph;
+    bool bHeadless;
+    uint32_t uHeadlessFrames;
+    double dAlpha;
 
     tScene *sScene;
 } tRuntime;
@@ -154,6 +179,38 @@ tLayer* tRuntimeGetCurrentLayer(tRuntime *tRun) __attribute__((nonnull(1)));
  * */
 void vRuntimeUnsleepCurrentLayer(tRuntime *tRun, bool ignoreNextSleep);
 
+/* 
+ *  @brief - parks the currently running layer, so it won't be run at all for the provided time.
+ *
+ *  Unlike the sleep clauses, which still run the layer on each tick, parked layers cost nothing
+ *  until their deadline within the scheduler is due.
+ * */
+void vFeatherParkThisLayerMs(tRuntime *tRun, uint32_t ms) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - parks the currently running layer for the provided amount of update ticks.
+ * */
+void vFeatherParkThisLayerTicks(tRuntime *tRun, uint32_t uTicks) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - calls the function once after the provided amount of milliseconds.
+ *
+ *  Returns the timer's identifier, which can be used to cancel it, or zero on failure.
+ * */
+uint32_t uFeatherAfterMs(tRuntime *tRun, uint32_t ms, fTimerFn fFn, void *vUserData) __attribute__((nonnull(1, 3)));
+
+/* 
+ *  @brief - calls the function repeatedly, each time the provided amount of milliseconds passes.
+ *
+ *  Returns the timer's identifier, which can be used to cancel it, or zero on failure.
+ * */
+uint32_t uFeatherEveryMs(tRuntime *tRun, uint32_t ms, fTimerFn fFn, void *vUserData) __attribute__((nonnull(1, 3)));
+
+/* 
+ *  @brief - cancels the pending timer of the current scene. Returns false if no such timer is pending.
+ * */
+bool bFeatherCancelTimer(tRuntime *tRun, uint32_t uTimerId) __attribute__((nonnull(1)));
+
 /* 
  *  @brief - handles input operations to listen upcoming input from keyboard, mouse, joystick, etc.
  *
@@ -244,6 +301,17 @@ void vMouseOnWheel(tMouseController* tMouseCtrl, tRect *tRct, fHandler fHnd);
 
 tRect* tInitRect(tRuntime *tRun, tContext2D tCtx, uint16_t uPriority, char* sTexturePath);
 
+/* 
+ *  @brief - removes the rect from the current scene.
+ *
+ *  @tRun - currently running runtime.
+ *  @tRct - pointer to the rect to remove. It is invalid after this call.
+ *
+ *  The texture is released, so it is destroyed if no other rect is using it anymore.
+ *  The rect's physical body is removed from the scene's physics world as well.
+ * */
+void vDestroyRect(tRuntime *tRun, tRect *tRct) __attribute__((nonnull(1, 2)));
+
 /* 
  *  @brief - draws the rectangle to the screen.
  *
@@ -260,13 +328,15 @@ void vDrawRect(tRuntime *tRun, tRect *rect) __attribute__((nonnull(1)));
  *  @tRun            - currently running runtime.
  *  @tRct            - pointer to the rectange we wish to change
  *  @sNewTexturePath - path to the new texture source.
+ *
+ *  The frame is reset to the whole new texture, sprite sheets shall be indexated again.
  * */
 void vChangeRectTexture(tRuntime* tRun, tRect* tRct, char* sNewTexturePath) __attribute__((nonnull(1, 2)));
 
 /* 
  *  Provides a proper pointer to the rect, based on it's ID.
  *
- *  This must be used to prevent pointer problems, when more rects are added.
+ *  Lookup is O(1). Returns NULL if the rect was destroyed, even if it's slot was reused since.
  * */
 tRect *tGetRect(tRuntime *tRun, uint32_t uRectId);
 
@@ -333,7 +403,8 @@ int __vRectFromTextureRaw(tRuntime *tRun, tRect *tRct, SDL_Surface *sdlSurf);
  *  @tRct          - Pointer to the rectangle.
  *  @fallbackColor - New fallback color to apply.
  *
- *  This also destroys the currently applied texture. Here Ctx width and height decides the size of the color.
+ *  This also releases the currently applied texture. Here Ctx width and height decides the size of the color.
+ *  Once the rect is in color mode, changing the color is a plain store without any allocation.
  */
 void vChangeRectColor(tRuntime* tRun, tRect* tRct, SDL_Color fallbackColor) __attribute__((nonnull(1, 2)));
 
@@ -347,7 +418,16 @@ void vChangeRectColor(tRuntime* tRun, tRect* tRct, SDL_Color fallbackColor) __at
         .sdlRenderer = NULL,                        \
         .wRunWindow = NULL,                         \
         .sScene = NULL,                             \
-        .tMixer = { tll_init(), tll_init(), {0} }   \
+        .tMixer = { tll_init(), tll_init(), {0} },  \
+        .tTextures = {0},                           \
+        .tGlyphs = {0},                             \
+        .tBatch = { NULL, NULL, 0, 0, NULL, 0 },    \
+        .tRender = NULL,                            \
+        .tJobs = NULL,                              \
+        .tLayerGraph = {0},                         \
+        .bHeadless = FEATHER_HEADLESS,              \
+        .uHeadlessFrames = FEATHER_HEADLESS_FRAMES, \
+        .dAlpha = 0.                                \
     };
 
 /* 
@@ -31,20 +31,13 @@
 #include <tllist.h>
 #include <stdint.h>
 
-/* 
- *  @brief - additional structure that provides a way to observe colliders.
- *
- *  Only four parameters is required.
- * */
-typedef struct {
-    double x, y, w, h;
-    uint32_t uColliderId, uCollidersGroup;
-} tColliderLabel;
+#include <spatial.h>
 
 typedef tll(tColliderLabel) tColliders;
 
 #include <controller.h>
 #include <layer.h>
+#include <scheduler.h>
 #include <rect.h>
 
 
@@ -52,6 +45,12 @@ typedef tll(tColliderLabel) tColliders;
  *  @brief - defines a structure of one generic scene.
  *
  *  @lLayers - list of layers, which are user defined handler function for each scene.
+ *  @tCtrlIndex - controllers of the scene indexed by their event type.
+ *  @tMouseTargets - rects with mouse handlers, indexed by their position.
+ *  @tRects  - dense storage of all rects drawn within the scene.
+ *  @tPhysics - physics world of the scene. Allocated by the first physical body.
+ *  @tTimers - pending wake-ups of parked layers and timer callbacks.
+ *  @tCurrentLayer - layer which is currently running, or NULL outside of the layers.
  *
  *  Each scene contains a set of handler function to provide the main user program's
  *  logic. The main engine's runtime can handle only one scene at a time. A scene can have
@@ -61,9 +60,13 @@ typedef struct {
     char* sName;
     tLayerList lLayers;
     tControllerList lControllers;
-    tRectList lRects;
-    tColliders lColliders;
+    tControllerIndex tCtrlIndex;
+    tMouseIndex tMouseTargets;
+    tRectPool tRects;
+    struct tPhysicsWorld *tPhysics;
+    tScheduler tTimers;
 
+    tLayer *tCurrentLayer;
     uint32_t uCurrentRunningLayerId;
     uint32_t uCurrentRunningControllerId;
 } tScene;
@@ -100,8 +103,12 @@ void vSceneRemoveController(tScene *sScene, uint32_t uControllerID) __attribute_
         .sName = #scName,               \
         .lLayers = tll_init(),          \
         .lControllers = tll_init(),     \
-        .lRects = tll_init(),           \
-        .lColliders = tll_init(),       \
+        .tCtrlIndex = {0},              \
+        .tMouseTargets = {{0}},         \
+        .tRects = {0},                  \
+        .tPhysics = NULL,               \
+        .tTimers = {{0}},               \
+        .tCurrentLayer = NULL,          \
         .uCurrentRunningLayerId = 0,    \
         .uCurrentRunningControllerId = 0\
     };                                  \
@@ -0,0 +1,147 @@
+/**************************************************************************************************
+ *  File: scheduler.h
+ *  Desc: Timer scheduler of the scene. Sleeping layers and delayed callbacks register their wake-up
+ *  deadline within a binary min-heap keyed on high-resolution ticks, so only due entries are touched.
+ **************************************************************************************************
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ * */
+
+#pragma once
+
+#ifndef FEATHER_SCHEDULER_H
+#define FEATHER_SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <layer.h>
+#include <intrinsics.h>
+
+/* 
+ *  @brief - callback invoked once it's timer is due.
+ * */
+typedef void (*fTimerFn)(void *tRun, void *vUserData);
+
+/* 
+ *  @brief - one pending wake-up within the scheduler.
+ *
+ *  @uDeadline  - tick at which the timer is due.
+ *  @uPeriod    - amount of ticks between repetitions. Zero for one-shot timers.
+ *  @bTicks     - deadline and period are counted in update ticks instead of high-resolution ticks.
+ *  @uTimerId   - identifier returned when the timer was added.
+ *  @tLr        - parked layer to wake up, or NULL for callback timers.
+ *  @fFn        - callback of the timer.
+ *  @vUserData  - pointer passed to the callback.
+ * */
+typedef struct {
+    uint64_t uDeadline, uPeriod;
+    bool bTicks;
+    uint32_t uTimerId;
+    tLayer *tLr;
+    fTimerFn fFn;
+    void *vUserData;
+} tTimer;
+
+/* 
+ *  @brief - binary min-heap of timers ordered by their deadline.
+ *
+ *  @tTimers    - heap storage.
+ *  @uCount     - amount of pending timers.
+ *  @uCapacity  - capacity of the heap storage.
+ * */
+typedef struct {
+    tTimer *tTimers;
+    uint32_t uCount, uCapacity;
+} tTimerHeap;
+
+/* 
+ *  @brief - scheduler holding both timed and tick counted wake-ups.
+ *
+ *  @tByTime    - timers with deadlines in high-resolution ticks.
+ *  @tByTick    - timers with deadlines in update ticks.
+ *  @uTick      - amount of update ticks run so far.
+ *  @uNextId    - identifier of the next added timer.
+ *  @iLock      - guards adding and cancelling, which may happen from concurrent layers.
+ *
+ *  Zero initialized scheduler is a valid empty one.
+ * */
+typedef struct {
+    tTimerHeap tByTime, tByTick;
+    uint64_t uTick;
+    uint32_t uNextId;
+    SDL_SpinLock iLock;
+} tScheduler;
+
+/* 
+ *  @brief - returns the current high-resolution tick.
+ * */
+uint64_t uSchedulerNow(void);
+
+/* 
+ *  @brief - converts milliseconds to high-resolution ticks.
+ * */
+uint64_t uSchedulerTicksFromMs(uint32_t ms);
+
+/* 
+ *  @brief - returns the current time in milliseconds. Used by the engine instead of SDL_GetTicks.
+ * */
+uint32_t uSchedulerNowMs(void);
+
+/* 
+ *  @brief - switches the engine's time to a virtual clock, which only moves with 'vSchedulerAdvanceMs'.
+ *
+ *  Makes runs independent from the wall clock, so they are reproducible. Must be called before any timer is added.
+ * */
+void vSchedulerUseVirtualClock(void);
+
+/* 
+ *  @brief - moves the virtual clock forward. Ignored when the real clock is used.
+ * */
+void vSchedulerAdvanceMs(uint32_t ms);
+
+/* 
+ *  @brief - adds the timer to the heap. Returns it's identifier, or zero on failure.
+ *
+ *  Deadlines of tick counted timers are relative to the scheduler's uTick.
+ * */
+uint32_t uSchedulerAdd(tScheduler *tSched, tTimer tTm) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - removes the pending timer. Returns false if no such timer is pending.
+ * */
+bool bSchedulerCancel(tScheduler *tSched, uint32_t uTimerId) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - removes all pending wake-ups of the layer, leaving it unparked.
+ * */
+void vSchedulerCancelLayer(tScheduler *tSched, tLayer *tLr) __attribute__((nonnull(1, 2)));
+
+/* 
+ *  @brief - advances the update tick and pops all due timers, waking up their layers and calling their callbacks.
+ *
+ *  Costs O(log n) per due timer and a single comparison per heap when nothing is due.
+ * */
+void vSchedulerRun(tScheduler *tSched, void *tRun) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - frees the heaps without calling any pending callback.
+ * */
+void vSchedulerFree(tScheduler *tSched) __attribute__((nonnull(1)));
+
+#endif
@@ -0,0 +1,151 @@
+/**************************************************************************************************
+ *  File: spatial.h
+ *  Desc: Uniform grid spatial hash. Broadphase for the physics colliders.
+ **************************************************************************************************
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ * */
+
+
+#pragma once
+
+#ifndef FEATHER_SPATIAL_H
+#define FEATHER_SPATIAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* 
+ *  @brief - additional structure that provides a way to observe colliders.
+ *
+ *  Only four parameters is required.
+ * */
+typedef struct {
+    double x, y, w, h;
+    uint32_t uColliderId, uCollidersGroup;
+} tColliderLabel;
+
+/* 
+ *  @brief - one collider within the spatial hash, together with the cells it currently covers.
+ *
+ *  @tLabel         - bounds and identity of the collider.
+ *  @iMinX, iMinY   - first covered cell.
+ *  @iMaxX, iMaxY   - last covered cell.
+ *  @uStamp         - last query that visited this entry. Used to report each candidate once.
+ *  @bUsed          - false for free entries.
+ * */
+typedef struct {
+    tColliderLabel tLabel;
+    int32_t iMinX, iMinY, iMaxX, iMaxY;
+    uint32_t uStamp;
+    bool bUsed;
+} tSpatialEntry;
+
+/* 
+ *  @brief - one grid cell, holding indices of all entries overlapping it.
+ * */
+typedef struct {
+    int32_t iX, iY;
+    uint32_t *uItems;
+    uint32_t uCount, uCapacity;
+    bool bUsed;
+} tSpatialCell;
+
+/* 
+ *  @brief - uniform grid over the world, with cells stored in an open addressing hash table.
+ *
+ *  @tEntries       - all colliders. Indices are stable until the collider is removed.
+ *  @uEntries       - amount of used entry slots, including the freed ones.
+ *  @uEntryCapacity - allocated amount of entries.
+ *  @uFree          - stack of removed entries, reused by later insertions.
+ *  @uFreeCount     - amount of entries within the free stack.
+ *  @tCells         - hash table of touched cells. Emptied cells are dropped when the table is rebuilt.
+ *  @uCells         - amount of cells within the table, including the emptied ones.
+ *  @uCellCapacity  - amount of cell slots. Always a power of two.
+ *  @uResults       - reusable buffer holding the candidates of the last query.
+ *  @uResultCapacity- capacity of the result buffer.
+ *  @uStamp         - incremented on every query.
+ *
+ *  Zero initialized hash is a valid empty one. Colliders are updated incrementally, only the
+ *  cells they leave or enter are touched.
+ * */
+typedef struct {
+    tSpatialEntry *tEntries;
+    uint32_t uEntries, uEntryCapacity;
+    uint32_t *uFree;
+    uint32_t uFreeCount;
+
+    tSpatialCell *tCells;
+    uint32_t uCells, uCellCapacity;
+
+    uint32_t *uResults;
+    uint32_t uResultCapacity;
+    uint32_t uStamp;
+} tSpatialHash;
+
+/* 
+ *  @brief - inserts a new collider. Returns it's entry index or UINT32_MAX on failure.
+ * */
+uint32_t uSpatialInsert(tSpatialHash *tHash, tColliderLabel tLabel) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - moves the collider to new bounds, relinking only the cells that changed.
+ * */
+void vSpatialUpdate(tSpatialHash *tHash, uint32_t uEntry, double x, double y, double w, double h) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - removes the collider from the hash. It's entry index may be reused.
+ * */
+void vSpatialRemove(tSpatialHash *tHash, uint32_t uEntry) __attribute__((nonnull(1)));
+
+/* 
+ *  @brief - collects other colliders of the same group sharing a cell with the provided one.
+ *
+ *  @tHash      - spatial hash.
+ *  @uEntry     - collider to query around.
+ *  @uOut       - receives the internal buffer of entry indices, valid until the next query.
+ *
+ *  Returns the amount of candidates. Candidates still have to pass the narrowphase.
+ * */
+uint32_t uSpatialQuery(tSpatialHash *tHash, uint32_t uEntry, uint32_t **uOut) __attribute__((nonnull(1, 3)));
+
+/* 
+ *  @brief - collects all entries, regardless of their group, whose bounds contain the point.
+ *
+ *  @tHash      - spatial hash.
+ *  @x, y       - queried point.
+ *  @uOut       - receives the internal buffer of entry indices, valid until the next query.
+ *
+ *  Only the single cell under the point is visited. Returns the amount of entries found.
+ * */
+uint32_t uSpatialQueryPoint(tSpatialHash *tHash, double x, double y, uint32_t **uOut) __attribute__((nonnull(1, 4)));
+
+/* 
+ *  @brief - returns the label of the entry.
+ * */
+static inline tColliderLabel* tSpatialLabel(tSpatialHash *tHash, uint32_t uEntry) {
+    return &tHash->tEntries[uEntry].tLabel;
+}
+
+/* 
+ *  @brief - frees all memory owned by the hash.
+ * */
+void vSpatialFree(tSpatialHash *tHash) __attribute__((nonnull(1)));
+
+#endif
@@ -0,0 +1,109 @@
+/**************************************************************************************************
+ *  File: texture.h
+ *  Desc: Shared texture cache. Textures are loaded once per path and handed out to every rect that
+ *  requests the same image, with a reference count deciding when the GPU texture can be destroyed.
+ **************************************************************************************************
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ * */
+
+#pragma once
+
+#ifndef FEATHER_TEXTURE_H
+#define FEATHER_TEXTURE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <intrinsics.h>
+
+/*
+ *  @brief - one loaded texture within the cache.
+ *
+ *  @sPath          - owned copy of the path, used as the cache key.
+ *  @sdlTexture     - underlying GPU texture.
+ *  @uWidth         - width of the whole texture in pixels.
+ *  @uHeight        - height of the whole texture in pixels.
+ *  @uRefCount      - amount of users currently holding this texture.
+ * */
+typedef struct {
+    char *sPath;
+    SDL_Texture *sdlTexture;
+    uint32_t uWidth, uHeight;
+    uint32_t uRefCount;
+} tTexture;
+
+/*
+ *  @brief - destroys a texture released by the cache.
+ * */
+typedef void (*fTextureDestroy)(void *vCtx, SDL_Texture *sdlTexture);
+
+/*
+ *  @brief - runtime owned texture cache keyed by the texture path.
+ *
+ *  @tEntries   - open addressing table of loaded textures.
+ *  @uCapacity  - amount of slots within the table. Always a power of two.
+ *  @uCount     - amount of currently loaded textures.
+ *  @sdlWhite   - shared 1x1 white texture, which is tinted to draw solid color rects.
+ *  @fDestroy   - called instead of SDL_DestroyTexture when set, so destruction can be deferred.
+ *  @vDestroyCtx - context passed to 'fDestroy'.
+ *
+ *  Pointers to the entries are only valid until the next acquire or release call, since the table
+ *  may be rehashed. Rects therefore keep the SDL texture and the path, not the entry itself.
+ * */
+typedef struct {
+    tTexture *tEntries;
+    uint32_t uCapacity, uCount;
+    SDL_Texture *sdlWhite;
+    fTextureDestroy fDestroy;
+    void *vDestroyCtx;
+} tTextureCache;
+
+/*
+ *  @brief - obtains a texture for the provided path, loading it on the first request.
+ *
+ *  @tCache     - runtime's texture cache.
+ *  @sdlRend    - renderer used to upload the texture on a cache miss.
+ *  @sPath      - path to the texture source.
+ *
+ *  Increments the reference count of the texture. Returns NULL if the texture can't be loaded.
+ * */
+tTexture* tTextureCacheAcquire(tTextureCache *tCache, SDL_Renderer *sdlRend, const char *sPath) __attribute__((nonnull(1, 3)));
+
+/*
+ *  @brief - drops one reference of the texture under the provided path.
+ *
+ *  The texture is destroyed once the last reference is released. Returns false if the path is not
+ *  owned by the cache, so the caller knows that the texture must be destroyed manually.
+ * */
+bool bTextureCacheRelease(tTextureCache *tCache, const char *sPath) __attribute__((nonnull(1)));
+
+/*
+ *  @brief - returns the shared 1x1 white texture, creating it on the first call.
+ *
+ *  The texture is not reference counted and lives as long as the cache itself. Solid color rects
+ *  tint it with their color instead of owning a texture of their own.
+ * */
+SDL_Texture* sdlTextureCacheWhite(tTextureCache *tCache, SDL_Renderer *sdlRend) __attribute__((nonnull(1)));
+
+/*
+ *  @brief - destroys all cached textures regardless of their reference count.
+ * */
+void vTextureCacheFree(tTextureCache *tCache) __attribute__((nonnull(1)));
+
+#endif
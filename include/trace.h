@@ -0,0 +1,106 @@
+/**************************************************************************************************
+ *  File: trace.h
+ *  Desc: Trace writer. Timed scopes are recorded into per-thread buffers and written out as a Chrome
+ *  trace-event JSON file, which can be opened by chrome://tracing or Perfetto.
+ **************************************************************************************************
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ * */
+
+#pragma once
+
+#ifndef FEATHER_TRACE_H
+#define FEATHER_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <intrinsics.h>
+
+/* 
+ *  @brief - one complete event of the timeline.
+ *
+ *  @sCat       - category of the event. Must be a static string.
+ *  @sName      - name of the event, copied when recorded.
+ *  @uStart     - high-resolution tick when the event began.
+ *  @uEnd       - high-resolution tick when the event ended.
+ * */
+typedef struct {
+    const char *sCat;
+    char sName[48];
+    uint64_t uStart, uEnd;
+} tTraceEvent;
+
+/* 
+ *  @brief - events recorded by one thread since the last flush.
+ *
+ *  @tEvents    - fixed array of FEATHER_TRACE_BUFFER_EVENTS events.
+ *  @uCount     - amount of recorded events.
+ *  @uDropped   - amount of events lost, since the buffer was full.
+ *  @uThread    - identifier of the owning thread, used as the trace's tid.
+ *  @iLock      - guards the buffer against a flush from another thread.
+ *  @tNext      - next buffer within the list of all threads.
+ * */
+typedef struct tTraceBuffer {
+    tTraceEvent *tEvents;
+    uint32_t uCount, uDropped;
+    unsigned long uThread;
+    SDL_SpinLock iLock;
+    struct tTraceBuffer *tNext;
+} tTraceBuffer;
+
+#if FEATHER_TRACE
+/* 
+ *  @brief - starts timing a traced scope by declaring the start timestamp.
+ * */
+#define FEATHER_TRACE_BEGIN(uStart) \
+    uint64_t uStart = SDL_GetPerformanceCounter()
+
+/* 
+ *  @brief - records the scope started by 'FEATHER_TRACE_BEGIN' with a printf formatted name.
+ * */
+#define FEATHER_TRACE_END(uStart, sCat, ...) \
+    vTraceComplete(sCat, uStart, SDL_GetPerformanceCounter(), __VA_ARGS__)
+#else
+#define FEATHER_TRACE_BEGIN(uStart)
+#define FEATHER_TRACE_END(uStart, sCat, ...)
+#endif
+
+/* 
+ *  @brief - records a complete event into the calling thread's buffer.
+ *
+ *  @sCat       - category of the event. Must be a static string.
+ *  @uStart     - high-resolution tick when the event began.
+ *  @uEnd       - high-resolution tick when the event ended.
+ *  @sFmt       - printf format of the event's name.
+ * */
+void vTraceComplete(const char *sCat, uint64_t uStart, uint64_t uEnd, const char *sFmt, ...) __attribute__((format(printf, 4, 5)));
+
+/* 
+ *  @brief - writes all recorded events to FEATHER_TRACE_FILE and empties the buffers.
+ *
+ *  The file is created by the first flush. Can be called at any time, e.g. right after a frame spike.
+ * */
+void vTraceFlush(void);
+
+/* 
+ *  @brief - flushes the remaining events, finishes the JSON file and frees all buffers.
+ * */
+void vTraceClose(void);
+
+#endif
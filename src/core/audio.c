@@ -31,6 +31,7 @@
 #include <runtime.h>
 #include <intrinsics.h>
 #include <log.h>
+#include <trace.h>
 
 /* 
  *  @brief - load a sound effect from file to the sound chunk list.
@@ -49,8 +50,10 @@ uint32_t uLoadMixerSound(tRuntime *tRun, const char* sFilePath) {
     }
 
     vFeatherLogInfo("Loading asset: Sound: %s...", strrchr(sFilePath, '/') + 1);
+    FEATHER_TRACE_BEGIN(uStart);
     tCh = *Mix_LoadWAV(sFilePath);
     tll_push_back(tRun->tMixer.tChunks, tCh);
+    FEATHER_TRACE_END(uStart, "asset", "uLoadMixerSound %s", sFilePath);
     return tll_length(tRun->tMixer.tChunks) - 1;
 }
 
@@ -0,0 +1,200 @@
+/**************************************************************************************************
+ *  File: batch.c
+ *  Desc: Sprite batching. Consecutive rects sharing a texture are submitted as one geometry draw.
+ **************************************************************************************************
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ * */
+
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <batch.h>
+#include <glyph.h>
+#include <intrinsics.h>
+#include <log.h>
+
+#define __BATCH_INITIAL_CAPACITY 256
+
+static int __iBatchGrow(tRenderBatch *tBatch) {
+    uint32_t uNewCapacity = tBatch->uCapacity ? tBatch->uCapacity * 2 : __BATCH_INITIAL_CAPACITY;
+
+    SDL_Vertex *sdlVerts = realloc(tBatch->sdlVerts, uNewCapacity * 4 * sizeof(SDL_Vertex));
+    if (sdlVerts == NULL)
+        return -1;
+    tBatch->sdlVerts = sdlVerts;
+
+    int *iIndices = realloc(tBatch->iIndices, uNewCapacity * 6 * sizeof(int));
+    if (iIndices == NULL)
+        return -1;
+    tBatch->iIndices = iIndices;
+
+    // Quad topology never changes, so indices are only written for the new slots.
+    for (uint32_t i = tBatch->uCapacity; i < uNewCapacity; ++i) {
+        int iBase = i * 4;
+        int *iQuad = &tBatch->iIndices[i * 6];
+        iQuad[0] = iBase;     iQuad[1] = iBase + 1; iQuad[2] = iBase + 2;
+        iQuad[3] = iBase + 2; iQuad[4] = iBase + 3; iQuad[5] = iBase;
+    }
+
+    tBatch->uCapacity = uNewCapacity;
+    return 0;
+}
+
+/* 
+ *  @brief - queues the rect into the batch, flushing the previous run if the texture differs.
+ *
+ *  @tBatch     - runtime's render batch.
+ *  @sdlRend    - renderer used for flushing.
+ *  @tRct       - rect to draw.
+ * */
+void vBatchPushRect(tRenderBatch *tBatch, SDL_Renderer *sdlRend, tRect *tRct) {
+    tRenderCmd tCmd;
+
+    // Texts are one quad per glyph, all sampling the same atlas page in the common case.
+    if (tRct->tGlyphs != NULL) {
+        for (uint32_t i = 0; i < tRct->tGlyphs->uCount; ++i) {
+            tCmd = tGlyphRunCmd(tRct, i);
+            vBatchPushCmd(tBatch, sdlRend, &tCmd);
+        }
+        return;
+    }
+
+    tCmd = tBatchCmdFromRect(tRct);
+    vBatchPushCmd(tBatch, sdlRend, &tCmd);
+}
+
+/* 
+ *  @brief - queues a recorded draw command, flushing the previous run if the texture differs.
+ * */
+void vBatchPushCmd(tRenderBatch *tBatch, SDL_Renderer *sdlRend, const tRenderCmd *tCmd) {
+    float fU0, fV0, fU1, fV1, fW, fH, fCx, fCy, fSin, fCos;
+
+    if (tCmd->sdlTexture == NULL || tCmd->uTexWidth == 0 || tCmd->uTexHeight == 0)
+        return;
+
+    if (tCmd->sdlTexture != tBatch->sdlTexture) {
+        vBatchFlush(tBatch, sdlRend);
+        tBatch->sdlTexture = tCmd->sdlTexture;
+    }
+
+    if (tBatch->uQuads == tBatch->uCapacity && __iBatchGrow(tBatch) < 0) {
+        vFeatherLogError("Unable to grow the render batch.");
+        return;
+    }
+
+    // Normalized source rect of the current frame.
+    fU0 = (float)tCmd->sdlSrc.x / tCmd->uTexWidth;
+    fV0 = (float)tCmd->sdlSrc.y / tCmd->uTexHeight;
+    fU1 = (float)(tCmd->sdlSrc.x + tCmd->sdlSrc.w) / tCmd->uTexWidth;
+    fV1 = (float)(tCmd->sdlSrc.y + tCmd->sdlSrc.h) / tCmd->uTexHeight;
+
+    // Half extents around the center, rotated on the CPU. Rotation is in degrees like SDL_RenderCopyEx.
+    fW = tCmd->sdlDst.w * 0.5f;
+    fH = tCmd->sdlDst.h * 0.5f;
+    fCx = tCmd->sdlDst.x + fW;
+    fCy = tCmd->sdlDst.y + fH;
+    fSin = sinf(tCmd->fRotation * (float)M_PI / 180.0f);
+    fCos = cosf(tCmd->fRotation * (float)M_PI / 180.0f);
+
+    const float fCorners[4][4] = {
+        { -fW, -fH, fU0, fV0 },
+        {  fW, -fH, fU1, fV0 },
+        {  fW,  fH, fU1, fV1 },
+        { -fW,  fH, fU0, fV1 },
+    };
+
+    SDL_Vertex *sdlQuad = &tBatch->sdlVerts[tBatch->uQuads * 4];
+    for (int i = 0; i < 4; ++i) {
+        sdlQuad[i].position.x = fCx + fCorners[i][0] * fCos - fCorners[i][1] * fSin;
+        sdlQuad[i].position.y = fCy + fCorners[i][0] * fSin + fCorners[i][1] * fCos;
+        sdlQuad[i].tex_coord.x = fCorners[i][2];
+        sdlQuad[i].tex_coord.y = fCorners[i][3];
+        sdlQuad[i].color = tCmd->sdlColor;
+    }
+
+    tBatch->uQuads++;
+}
+
+/* 
+ *  @brief - records the current state of the rect as a draw command.
+ * */
+tRenderCmd tBatchCmdFromRect(const tRect *tRct) {
+    return (tRenderCmd) {
+        .sdlTexture = (SDL_Texture*)tRct->idTextureID,
+        .sdlSrc = tRct->sdlSrc,
+        .uTexWidth = tRct->uTexWidth,
+        .uTexHeight = tRct->uTexHeight,
+        .sdlDst = {
+            tRct->tCtx.fX, 
+            tRct->tCtx.fY, 
+            tRct->sdlSrc.w * tRct->tCtx.fScaleX, 
+            tRct->sdlSrc.h * tRct->tCtx.fScaleY,
+        },
+        .fRotation = tRct->tCtx.fRotation,
+        .sdlColor = tRct->sdlColor,
+    };
+}
+
+/* 
+ *  @brief - draws one command without batching, the same way 'vDrawRect' draws a rect.
+ * */
+void vDrawRenderCmd(SDL_Renderer *sdlRend, const tRenderCmd *tCmd) {
+    SDL_Rect sdlDst = { (int)tCmd->sdlDst.x, (int)tCmd->sdlDst.y, (int)tCmd->sdlDst.w, (int)tCmd->sdlDst.h };
+    SDL_Point sdlCenter = { sdlDst.w / 2, sdlDst.h / 2 };
+
+    if (tCmd->sdlTexture == NULL)
+        return;
+
+    SDL_SetTextureColorMod(tCmd->sdlTexture, tCmd->sdlColor.r, tCmd->sdlColor.g, tCmd->sdlColor.b);
+    SDL_SetTextureAlphaMod(tCmd->sdlTexture, tCmd->sdlColor.a);
+    SDL_RenderCopyEx(sdlRend, tCmd->sdlTexture, &tCmd->sdlSrc, &sdlDst, tCmd->fRotation, &sdlCenter, SDL_FLIP_NONE);
+}
+
+/* 
+ *  @brief - submits all queued rects with a single SDL_RenderGeometry call.
+ *
+ *  Must be called once after the last rect of the frame was pushed.
+ * */
+void vBatchFlush(tRenderBatch *tBatch, SDL_Renderer *sdlRend) {
+    if (tBatch->uQuads == 0)
+        return;
+
+    // Tint is carried by the vertex colors, the texture's own modulation must stay neutral.
+    SDL_SetTextureColorMod(tBatch->sdlTexture, 255, 255, 255);
+    SDL_SetTextureAlphaMod(tBatch->sdlTexture, 255);
+
+    if (SDL_RenderGeometry(sdlRend, tBatch->sdlTexture, tBatch->sdlVerts, tBatch->uQuads * 4, 
+                tBatch->iIndices, tBatch->uQuads * 6) < 0)
+        vFeatherLogError("Unable to render the batch: %s", SDL_GetError());
+
+    tBatch->uDrawCalls++;
+    tBatch->uQuads = 0;
+    tBatch->sdlTexture = NULL;
+}
+
+/* 
+ *  @brief - releases the vertex and index buffers of the batch.
+ * */
+void vBatchFree(tRenderBatch *tBatch) {
+    free(tBatch->sdlVerts);
+    free(tBatch->iIndices);
+    *tBatch = (tRenderBatch) {0};
+}
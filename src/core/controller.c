@@ -31,6 +31,8 @@
 #include <SDL_mouse.h>
 #include <SDL_scancode.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 #include <controller.h>
 #include <runtime.h>
 
@@ -52,6 +54,7 @@ uint32_t tControllerInit(tRuntime *tRun, SDL_EventType sdlEventType, void *vUser
         .fHnd = fHnd,
         .vUserData = vUserData,
         .uControllerID = uCCounter,
+        .sdlEvents = NULL, .uEventCount = 0, .uEventCapacity = 0,
         .uDelay = 0, .uControllerLastCalled = 0,
         .invoke = false,
     };
@@ -59,6 +62,146 @@ uint32_t tControllerInit(tRuntime *tRun, SDL_EventType sdlEventType, void *vUser
     return uCCounter;
 }
 
+/* 
+ *  @brief - queues the event for the next invocation of the controller.
+ *
+ *  If the controller is delayed, the events pile up and are delivered all at once, when the delay
+ *  passes. Returns false if the queue couldn't grow, in which case the event is dropped.
+ * */
+bool bControllerPushEvent(tController *tCtrl, const SDL_Event *sdlEvent) {
+    if (tCtrl->uEventCount == tCtrl->uEventCapacity) {
+        uint32_t uNewCapacity = tCtrl->uEventCapacity ? tCtrl->uEventCapacity * 2 : 8;
+        SDL_Event *sdlEvents = realloc(tCtrl->sdlEvents, uNewCapacity * sizeof(SDL_Event));
+        if (sdlEvents == NULL) {
+            vFeatherLogError("Unable to grow the controller event queue, event %u is dropped.", sdlEvent->type);
+            return false;
+        }
+        tCtrl->sdlEvents = sdlEvents;
+        tCtrl->uEventCapacity = uNewCapacity;
+    }
+
+    tCtrl->sdlEvents[tCtrl->uEventCount++] = *sdlEvent;
+    tCtrl->sdlEvent = *sdlEvent;
+    return true;
+}
+
+/* 
+ *  @brief - drops all queued events of the controller, while keeping the memory.
+ * */
+void vControllerClearEvents(tController *tCtrl) {
+    tCtrl->uEventCount = 0;
+}
+
+/* 
+ *  @brief - frees the event queue of the controller.
+ * */
+void vControllerFreeEvents(tController *tCtrl) {
+    free(tCtrl->sdlEvents);
+    tCtrl->sdlEvents = NULL;
+    tCtrl->uEventCount = tCtrl->uEventCapacity = 0;
+}
+
+#define __CONTROLLER_INDEX_INITIAL_CAPACITY 16
+
+static inline uint32_t __uControllerIndexSlot(tControllerIndex *tIndex, uint32_t sdlEventType) {
+    uint32_t uMask = tIndex->uCapacity - 1;
+    uint32_t uSlot = (sdlEventType * 2654435761u) & uMask;
+
+    while (tIndex->tBuckets[uSlot].bUsed && tIndex->tBuckets[uSlot].sdlEventType != sdlEventType)
+        uSlot = (uSlot + 1) & uMask;
+
+    return uSlot;
+}
+
+static int __iControllerIndexGrow(tControllerIndex *tIndex) {
+    tControllerIndex tNew = { 
+        .uCapacity = tIndex->uCapacity ? tIndex->uCapacity * 2 : __CONTROLLER_INDEX_INITIAL_CAPACITY,
+        .uBuckets = tIndex->uBuckets,
+    };
+
+    tNew.tBuckets = calloc(tNew.uCapacity, sizeof(tControllerBucket));
+    if (tNew.tBuckets == NULL)
+        return -1;
+
+    for (uint32_t i = 0; i < tIndex->uCapacity; ++i)
+        if (tIndex->tBuckets[i].bUsed)
+            tNew.tBuckets[__uControllerIndexSlot(&tNew, tIndex->tBuckets[i].sdlEventType)] = tIndex->tBuckets[i];
+
+    free(tIndex->tBuckets);
+    *tIndex = tNew;
+    return 0;
+}
+
+/* 
+ *  @brief - returns the bucket of the event type, or NULL if no controller ever listened on it.
+ * */
+tControllerBucket* tControllerIndexGet(tControllerIndex *tIndex, uint32_t sdlEventType) {
+    if (tIndex->uCapacity == 0)
+        return NULL;
+
+    tControllerBucket *tBucket = &tIndex->tBuckets[__uControllerIndexSlot(tIndex, sdlEventType)];
+    return tBucket->bUsed ? tBucket : NULL;
+}
+
+/* 
+ *  @brief - adds the controller to the bucket of it's event type.
+ * */
+void vControllerIndexAdd(tControllerIndex *tIndex, tController *tCtrl) {
+    tControllerBucket *tBucket = tControllerIndexGet(tIndex, tCtrl->sdlEventType);
+
+    if (tBucket == NULL) {
+        if ((tIndex->uBuckets + 1) * 4 > tIndex->uCapacity * 3 && __iControllerIndexGrow(tIndex) < 0) {
+            vFeatherLogError("Unable to grow the controller index.");
+            return;
+        }
+
+        tBucket = &tIndex->tBuckets[__uControllerIndexSlot(tIndex, tCtrl->sdlEventType)];
+        *tBucket = (tControllerBucket) { .sdlEventType = tCtrl->sdlEventType, .bUsed = true };
+        tIndex->uBuckets++;
+    }
+
+    if (tBucket->uCount == tBucket->uCapacity) {
+        uint32_t uNewCapacity = tBucket->uCapacity ? tBucket->uCapacity * 2 : 4;
+        tController **tCtrls = realloc(tBucket->tCtrls, uNewCapacity * sizeof(tController*));
+        if (tCtrls == NULL) {
+            vFeatherLogError("Unable to grow the controller index.");
+            return;
+        }
+        tBucket->tCtrls = tCtrls;
+        tBucket->uCapacity = uNewCapacity;
+    }
+
+    tBucket->tCtrls[tBucket->uCount++] = tCtrl;
+}
+
+/* 
+ *  @brief - removes the controller from the bucket of it's event type.
+ * */
+void vControllerIndexRemove(tControllerIndex *tIndex, tController *tCtrl) {
+    tControllerBucket *tBucket = tControllerIndexGet(tIndex, tCtrl->sdlEventType);
+    if (tBucket == NULL)
+        return;
+
+    // Order within the bucket is kept, so controllers are dispatched in the order they were added.
+    for (uint32_t i = 0; i < tBucket->uCount; ++i)
+        if (tBucket->tCtrls[i] == tCtrl) {
+            memmove(&tBucket->tCtrls[i], &tBucket->tCtrls[i + 1], (tBucket->uCount - i - 1) * sizeof(tController*));
+            tBucket->uCount--;
+            return;
+        }
+}
+
+/* 
+ *  @brief - frees all memory held by the index.
+ * */
+void vControllerIndexFree(tControllerIndex *tIndex) {
+    for (uint32_t i = 0; i < tIndex->uCapacity; ++i)
+        free(tIndex->tBuckets[i].tCtrls);
+
+    free(tIndex->tBuckets);
+    *tIndex = (tControllerIndex) {0};
+}
+
 /* 
  *  @brief - gives a pointer to the controller based on the provided ID.
  *
@@ -76,6 +219,70 @@ tController* tControllerGet(tRuntime *tRun, uint32_t uCtrlID) {
     return tCtrlPtr;
 }
 
+#define __KEY_BINDING_INITIAL_CAPACITY 16
+
+static inline uint32_t __uKeyBindingSlot(tKeyBindingMap *tMap, SDL_Keycode sdlKey) {
+    uint32_t uMask = tMap->uCapacity - 1;
+    uint32_t uSlot = ((uint32_t)sdlKey * 2654435761u) & uMask;
+
+    while (tMap->tSlots[uSlot].bUsed && tMap->tSlots[uSlot].sdlKey != sdlKey)
+        uSlot = (uSlot + 1) & uMask;
+
+    return uSlot;
+}
+
+static inline tKeyBinding* __tKeyBindingGet(tKeyBindingMap *tMap, SDL_Keycode sdlKey) {
+    if (tMap->uCapacity == 0)
+        return NULL;
+
+    tKeyBinding *tBinding = &tMap->tSlots[__uKeyBindingSlot(tMap, sdlKey)];
+    return tBinding->bUsed ? tBinding : NULL;
+}
+
+static void __vKeyBindingAdd(tKeyBindingMap *tMap, SDL_Keycode sdlKey, fHandler fHnd) {
+    tKeyBinding *tBinding = __tKeyBindingGet(tMap, sdlKey);
+
+    if (tBinding == NULL) {
+        // Keeping the load factor under 1/2, since misses are the common case for unbound keys.
+        if ((tMap->uUsed + 1) * 2 > tMap->uCapacity) {
+            tKeyBindingMap tNew = { 
+                .uCapacity = tMap->uCapacity ? tMap->uCapacity * 2 : __KEY_BINDING_INITIAL_CAPACITY,
+                .uUsed = tMap->uUsed,
+            };
+
+            tNew.tSlots = calloc(tNew.uCapacity, sizeof(tKeyBinding));
+            if (tNew.tSlots == NULL) {
+                vFeatherLogError("Unable to grow the key bindings.");
+                return;
+            }
+
+            for (uint32_t i = 0; i < tMap->uCapacity; ++i)
+                if (tMap->tSlots[i].bUsed)
+                    tNew.tSlots[__uKeyBindingSlot(&tNew, tMap->tSlots[i].sdlKey)] = tMap->tSlots[i];
+
+            free(tMap->tSlots);
+            *tMap = tNew;
+        }
+
+        tBinding = &tMap->tSlots[__uKeyBindingSlot(tMap, sdlKey)];
+        *tBinding = (tKeyBinding) { .sdlKey = sdlKey, .bUsed = true };
+        tMap->uUsed++;
+    }
+
+    if (tBinding->uCount == tBinding->uCapacity) {
+        uint32_t uNewCapacity = tBinding->uCapacity ? tBinding->uCapacity * 2 : 2;
+        fHandler *fHnds = realloc(tBinding->fHnds, uNewCapacity * sizeof(fHandler));
+        if (fHnds == NULL) {
+            vFeatherLogError("Unable to grow the key bindings.");
+            return;
+        }
+        tBinding->fHnds = fHnds;
+        tBinding->uCapacity = uNewCapacity;
+    }
+
+    tBinding->fHnds[tBinding->uCount++] = fHnd;
+}
+
 /* 
  *  @brief - Initializes a keyboard controller with a new controller.
  *
@@ -88,8 +295,8 @@ void vKeyboardControllerInit(tRuntime *tRun, tKeyboardController *tKeybCtrl) {
         tControllerInit(tRun, SDL_KEYDOWN, NULL, fControllerHandler(__vKeyboardControllerHandlerFn));
     tKeybCtrl->tCtrlPair.uUp = \ 
         tControllerInit(tRun, SDL_KEYUP, NULL, fControllerHandler(__vKeyboardControllerHandlerFn));
-    tKeybCtrl->tKeybHndPair.sdlPressed = (fKeyboardHandlerPairList) tll_init();
-    tKeybCtrl->tKeybHndPair.sdlReleased = (fKeyboardHandlerPairList) tll_init();
+    tKeybCtrl->tKeybHndPair.sdlPressed = (tKeyBindingMap) {0};
+    tKeybCtrl->tKeybHndPair.sdlReleased = (tKeyBindingMap) {0};
    
     tCtrlDown = tControllerGet(tRun, tKeybCtrl->tCtrlPair.uDown);
     tCtrlUp = tControllerGet(tRun, tKeybCtrl->tCtrlPair.uUp);
@@ -106,19 +313,40 @@ void vKeyboardControllerInit(tRuntime *tRun, tKeyboardController *tKeybCtrl) {
 void __vKeyboardControllerHandlerFn(void *vRun, tController *tCtrl) {
     tKeyboardController* tKeybCtrl = (tKeyboardController*)tCtrl->vUserData;
 
-    switch (tCtrl->sdlEvent.type) {
-        case SDL_KEYDOWN:
-            tll_foreach(tKeybCtrl->tKeybHndPair.sdlPressed, tPair)
-                if (tPair->item.sdlKey == tCtrl->sdlEvent.key.keysym.sym && tCtrl->sdlEvent.key.repeat == 0)
-                    tPair->item.fHnd(vRun, (struct tController*) tCtrl);
-            break;
-        case SDL_KEYUP:
-            tll_foreach(tKeybCtrl->tKeybHndPair.sdlReleased, tPair)
-                if (tPair->item.sdlKey == tCtrl->sdlEvent.key.keysym.sym && tCtrl->sdlEvent.key.repeat == 0)
-                    tPair->item.fHnd(vRun, (struct tController*) tCtrl);
-            break;
-        default:
-            break;
+    tKeyBindingMap *tMap;
+    tKeyBinding *tBinding;
+    SDL_Keycode sdlKey;
+
+    // Key handlers are called once per event, with the dispatched event in sdlEvent.
+    for (uint32_t i = 0; i < tCtrl->uEventCount; ++i) {
+        tCtrl->sdlEvent = tCtrl->sdlEvents[i];
+        if (tCtrl->sdlEvent.key.repeat != 0)
+            continue;
+
+        switch (tCtrl->sdlEvent.type) {
+            case SDL_KEYDOWN:
+                tMap = &tKeybCtrl->tKeybHndPair.sdlPressed;
+                break;
+            case SDL_KEYUP:
+                tMap = &tKeybCtrl->tKeybHndPair.sdlReleased;
+                break;
+            default:
+                continue;
+        }
+
+        sdlKey = tCtrl->sdlEvent.key.keysym.sym;
+        tBinding = __tKeyBindingGet(tMap, sdlKey);
+        if (tBinding == NULL)
+            continue;
+
+        // Latest bound handlers go first. Handlers binding new ones may reallocate the map, so the
+        // binding is looked up again before every call, and handlers added meanwhile wait for the next event.
+        for (uint32_t j = tBinding->uCount; j > 0; --j) {
+            tBinding = __tKeyBindingGet(tMap, sdlKey);
+            if (tBinding == NULL || tBinding->uCount < j)
+                break;
+            tBinding->fHnds[j - 1](vRun, (struct tController*) tCtrl);
+        }
     }
 }
 
@@ -126,16 +354,32 @@ void __vKeyboardControllerHandlerFn(void *vRun, tController *tCtrl) {
  *  @brief - append handler function for the keyboard controller on press event.  
  * */
 void vKeyboardOnPress(tKeyboardController* tKeyboardCtrl, SDL_Keycode sdlKey, fHandler fHnd) {
-    fKeyboardPair fPair = { .fHnd = fHnd, .sdlKey = sdlKey };
-    tll_push_front(tKeyboardCtrl->tKeybHndPair.sdlPressed, fPair);
+    __vKeyBindingAdd(&tKeyboardCtrl->tKeybHndPair.sdlPressed, sdlKey, fHnd);
 }
 
 /* 
  *  @brief - append handler function for the keyboard controller on release event.  
  * */
 void vKeyboardOnRelease(tKeyboardController* tKeyboardCtrl, SDL_Keycode sdlKey, fHandler fHnd) {
-    fKeyboardPair fPair = { .fHnd = fHnd, .sdlKey = sdlKey };
-    tll_push_front(tKeyboardCtrl->tKeybHndPair.sdlReleased, fPair);
+    __vKeyBindingAdd(&tKeyboardCtrl->tKeybHndPair.sdlReleased, sdlKey, fHnd);
+}
+
+static void __vKeyBindingMapFree(tKeyBindingMap *tMap) {
+    for (uint32_t i = 0; i < tMap->uCapacity; ++i)
+        free(tMap->tSlots[i].fHnds);
+
+    free(tMap->tSlots);
+    *tMap = (tKeyBindingMap) {0};
+}
+
+/* 
+ *  @brief - frees all key bindings of the keyboard controller.
+ *
+ *  Inner controllers are still owned by the scene and must be removed separately.
+ * */
+void vKeyboardControllerFree(tKeyboardController *tKeybCtrl) {
+    __vKeyBindingMapFree(&tKeybCtrl->tKeybHndPair.sdlPressed);
+    __vKeyBindingMapFree(&tKeybCtrl->tKeybHndPair.sdlReleased);
 }
 
 /* 
@@ -146,6 +390,143 @@ bool bFeatherIsKeyPressed(SDL_Scancode sdlKey) {
     return uKeyState[sdlKey];
 }
 
+#define __MOUSE_INDEX_INITIAL_CAPACITY 16
+
+static inline void __vMouseTargetBounds(tRect *tRct, double *x, double *y, double *w, double *h) {
+    *x = tRct->tCtx.fX;
+    *y = tRct->tCtx.fY;
+    *w = tRct->tCtx.fScaleX * tRct->tFr.uWidth;
+    *h = tRct->tCtx.fScaleY * tRct->tFr.uHeight;
+}
+
+static void __vMouseIndexDrop(tMouseIndex *tIndex, uint32_t uEntry) {
+    free(tIndex->tTargets[uEntry].tBindings);
+    tIndex->tTargets[uEntry] = (tMouseTarget) {0};
+    vSpatialRemove(&tIndex->tHash, uEntry);
+}
+
+/* Binds the handler to the target of the rect, adding the rect to the index on it's first binding. */
+static void __vMouseIndexBind(tMouseIndex *tIndex, tRect *tRct, tMouseBinding tBinding) {
+    tMouseTarget *tTarget = NULL;
+    double x, y, w, h;
+
+    // Binding happens rarely, so a linear walk is sufficient to find the existing target.
+    for (uint32_t i = 0; i < tIndex->tHash.uEntries; ++i)
+        if (tIndex->tTargets[i].tRct == tRct && tIndex->tTargets[i].uRectId == tRct->uRectId) {
+            tTarget = &tIndex->tTargets[i];
+            break;
+        }
+
+    if (tTarget == NULL) {
+        __vMouseTargetBounds(tRct, &x, &y, &w, &h);
+        uint32_t uEntry = uSpatialInsert(&tIndex->tHash, (tColliderLabel) { x, y, w, h, tRct->uRectId, 0 });
+        if (uEntry == UINT32_MAX) {
+            vFeatherLogError("Unable to insert the rect into the mouse index.");
+            return;
+        }
+
+        if (uEntry >= tIndex->uCapacity) {
+            uint32_t uNewCapacity = tIndex->uCapacity ? tIndex->uCapacity : __MOUSE_INDEX_INITIAL_CAPACITY;
+            while (uNewCapacity <= uEntry)
+                uNewCapacity *= 2;
+
+            tMouseTarget *tTargets = realloc(tIndex->tTargets, uNewCapacity * sizeof(tMouseTarget));
+            if (tTargets == NULL) {
+                vFeatherLogError("Unable to grow the mouse index.");
+                vSpatialRemove(&tIndex->tHash, uEntry);
+                return;
+            }
+            memset(&tTargets[tIndex->uCapacity], 0, (uNewCapacity - tIndex->uCapacity) * sizeof(tMouseTarget));
+            tIndex->tTargets = tTargets;
+            tIndex->uCapacity = uNewCapacity;
+        }
+
+        tTarget = &tIndex->tTargets[uEntry];
+        *tTarget = (tMouseTarget) { .tRct = tRct, .uRectId = tRct->uRectId };
+    }
+
+    if (tTarget->uCount == tTarget->uCapacity) {
+        uint32_t uNewCapacity = tTarget->uCapacity ? tTarget->uCapacity * 2 : 2;
+        tMouseBinding *tBindings = realloc(tTarget->tBindings, uNewCapacity * sizeof(tMouseBinding));
+        if (tBindings == NULL) {
+            vFeatherLogError("Unable to grow the mouse bindings.");
+            return;
+        }
+        tTarget->tBindings = tBindings;
+        tTarget->uCapacity = uNewCapacity;
+    }
+
+    tTarget->tBindings[tTarget->uCount++] = tBinding;
+}
+
+/* 
+ *  @brief - moves all targets to the current bounds of their rects and drops the removed rects.
+ * */
+void vMouseIndexRefresh(tMouseIndex *tIndex, tRectPool *tPool) {
+    double x, y, w, h;
+
+    for (uint32_t i = 0; i < tIndex->tHash.uEntries; ++i) {
+        tMouseTarget *tTarget = &tIndex->tTargets[i];
+        if (tTarget->tRct == NULL)
+            continue;
+
+        if (tRectPoolGet(tPool, tTarget->uRectId) != tTarget->tRct) {
+            __vMouseIndexDrop(tIndex, i);
+            continue;
+        }
+
+        // Only the cells the rect has left or entered are relinked.
+        __vMouseTargetBounds(tTarget->tRct, &x, &y, &w, &h);
+        vSpatialUpdate(&tIndex->tHash, i, x, y, w, h);
+    }
+}
+
+/* 
+ *  @brief - returns the topmost target under the point having a handler of the owner for the action, or NULL.
+ *
+ *  Targets are compared by the priority of their rects and by their creation within the same priority,
+ *  so picking follows the render order. Only bindings of the owner are considered, so targets bound by
+ *  another mouse controller never hide the owner's targets beneath them.
+ * */
+tMouseTarget* tMouseIndexPick(tMouseIndex *tIndex, double x, double y, eMouseAction eAction, uint8_t sdlButton,
+                             const void *vOwner) {
+    tMouseTarget *tTop = NULL;
+    uint32_t *uCandidates;
+    uint32_t uFound;
+
+    if (tIndex->tHash.uEntries == 0)
+        return NULL;
+
+    uFound = uSpatialQueryPoint(&tIndex->tHash, x, y, &uCandidates);
+    for (uint32_t i = 0; i < uFound; ++i) {
+        tMouseTarget *tTarget = &tIndex->tTargets[uCandidates[i]];
+        if (tTop != NULL && (tTarget->tRct->uPriority < tTop->tRct->uPriority || 
+                    (tTarget->tRct->uPriority == tTop->tRct->uPriority && tTarget->tRct->uSeq < tTop->tRct->uSeq)))
+            continue;
+
+        for (uint32_t j = 0; j < tTarget->uCount; ++j)
+            if (tTarget->tBindings[j].vOwner == vOwner && tTarget->tBindings[j].eAction == eAction &&
+                    tTarget->tBindings[j].sdlButton == sdlButton) {
+                tTop = tTarget;
+                break;
+            }
+    }
+
+    return tTop;
+}
+
+/* 
+ *  @brief - frees all memory held by the index.
+ * */
+void vMouseIndexFree(tMouseIndex *tIndex) {
+    for (uint32_t i = 0; i < tIndex->uCapacity; ++i)
+        free(tIndex->tTargets[i].tBindings);
+
+    free(tIndex->tTargets);
+    vSpatialFree(&tIndex->tHash);
+    *tIndex = (tMouseIndex) {0};
+}
+
 /* 
  *  @brief - initializes a freshly clean mouse controller.
  * */
@@ -165,6 +546,7 @@ void vMouseControllerInit(tRuntime *tRun, tMouseController *tMouseCtrl) {
     tMouseCtrl->tMouseHndBunch.sdlReleased = (fMouseKeyBunchList) tll_init();
     tMouseCtrl->tMouseHndBunch.sdlHover = (fMouseBunchList) tll_init();
     tMouseCtrl->tMouseHndBunch.sdlWheel = (fMouseBunchList) tll_init();
+    tMouseCtrl->tIndex = &tRun->sScene->tMouseTargets;
    
     tCtrlDown = tControllerGet(tRun, tMouseCtrl->tCtrlBunch.uDown);
     tCtrlUp = tControllerGet(tRun, tMouseCtrl->tCtrlBunch.uUp);
@@ -179,11 +561,28 @@ void vMouseControllerInit(tRuntime *tRun, tMouseController *tMouseCtrl) {
     tCtrlWheel->vUserData = tMouseCtrl;
 }
 
-bool __vIfMouseInRect(int32_t mx, int32_t my, tRect *tRct) {
-    if (tRct == NULL)
-        return true;
+/* Calls handlers of the controller bound to the topmost target under the point. */
+static void __vMouseDispatchTarget(void *vRun, tController *tCtrl, int32_t x, int32_t y, eMouseAction eAction, uint8_t sdlButton) {
+    tMouseController* tMouseCtrl = (tMouseController*)tCtrl->vUserData;
+    tMouseIndex *tIndex = tMouseCtrl->tIndex;
+    tMouseTarget *tTarget = tMouseIndexPick(tIndex, x, y, eAction, sdlButton, tMouseCtrl);
+    uint32_t uEntry, uCount;
+    tRect *tRct;
+
+    if (tTarget == NULL)
+        return;
 
-    return (mx >= tRct->tCtx.fX && mx <= tRct->tCtx.fX + tRct->tCtx.fScaleX * tRct->tFr.uWidth && my >= tRct->tCtx.fY && my <= tRct->tCtx.fY + tRct->tCtx.fScaleX * tRct->tFr.uHeight);
+    // Latest bound handlers go first, like the handlers without a rect. Handlers binding new handlers
+    // reallocate the targets and their bindings, so the target is looked up again before every call.
+    // Bindings added meanwhile are called from the next event on.
+    uEntry = tTarget - tIndex->tTargets;
+    uCount = tTarget->uCount;
+    tRct = tTarget->tRct;
+    for (uint32_t i = uCount; i > 0 && uEntry < tIndex->uCapacity && tIndex->tTargets[uEntry].tRct == tRct; --i) {
+        tMouseBinding tBinding = tIndex->tTargets[uEntry].tBindings[i - 1];
+        if (tBinding.vOwner == tMouseCtrl && tBinding.eAction == eAction && tBinding.sdlButton == sdlButton)
+            tBinding.fHnd(vRun, (struct tController*) tCtrl);
+    }
 }
 
 /* 
@@ -192,33 +591,41 @@ bool __vIfMouseInRect(int32_t mx, int32_t my, tRect *tRct) {
 void __vMouseControllerHandlerFn(void *vRun, tController *tCtrl) {
     tMouseController* tMouseCtrl = (tMouseController*)tCtrl->vUserData;
     int32_t mx, my;
-    SDL_GetMouseState(&mx, &my);
 
-    switch (tCtrl->sdlEvent.type) {
-        case SDL_MOUSEBUTTONDOWN:
-            tll_foreach(tMouseCtrl->tMouseHndBunch.sdlPressed, tBunch)
-                if (tBunch->item.sdlButton == tCtrl->sdlEvent.button.button)
-                    if (__vIfMouseInRect(mx, my, (tRect*)tBunch->item.tRct))
+    // Mouse handlers are called once per event, with the dispatched event in sdlEvent.
+    for (uint32_t i = 0; i < tCtrl->uEventCount; ++i) {
+        tCtrl->sdlEvent = tCtrl->sdlEvents[i];
+
+        switch (tCtrl->sdlEvent.type) {
+            case SDL_MOUSEBUTTONDOWN:
+                tll_foreach(tMouseCtrl->tMouseHndBunch.sdlPressed, tBunch)
+                    if (tBunch->item.sdlButton == tCtrl->sdlEvent.button.button)
                         tBunch->item.fHnd(vRun, (struct tController*) tCtrl);
-            break;
-        case SDL_MOUSEBUTTONUP:
-            tll_foreach(tMouseCtrl->tMouseHndBunch.sdlReleased, tBunch)
-                if (tBunch->item.sdlButton == tCtrl->sdlEvent.button.button)
-                    if (__vIfMouseInRect(mx, my, (tRect*)tBunch->item.tRct))
+                __vMouseDispatchTarget(vRun, tCtrl, tCtrl->sdlEvent.button.x, tCtrl->sdlEvent.button.y, 
+                        MOUSE_PRESS, tCtrl->sdlEvent.button.button);
+                break;
+            case SDL_MOUSEBUTTONUP:
+                tll_foreach(tMouseCtrl->tMouseHndBunch.sdlReleased, tBunch)
+                    if (tBunch->item.sdlButton == tCtrl->sdlEvent.button.button)
                         tBunch->item.fHnd(vRun, (struct tController*) tCtrl);
-            break;
-        case SDL_MOUSEMOTION:
-            tll_foreach(tMouseCtrl->tMouseHndBunch.sdlHover, tBunch) 
-                if (__vIfMouseInRect(mx, my, (tRect*)tBunch->item.tRct))
+                __vMouseDispatchTarget(vRun, tCtrl, tCtrl->sdlEvent.button.x, tCtrl->sdlEvent.button.y, 
+                        MOUSE_RELEASE, tCtrl->sdlEvent.button.button);
+                break;
+            case SDL_MOUSEMOTION:
+                tll_foreach(tMouseCtrl->tMouseHndBunch.sdlHover, tBunch) 
                     tBunch->item.fHnd(vRun, (struct tController*) tCtrl);
-            break;
-        case SDL_MOUSEWHEEL:
-            tll_foreach(tMouseCtrl->tMouseHndBunch.sdlWheel, tBunch)
-                if (__vIfMouseInRect(mx, my, (tRect*)tBunch->item.tRct))
+                __vMouseDispatchTarget(vRun, tCtrl, tCtrl->sdlEvent.motion.x, tCtrl->sdlEvent.motion.y, MOUSE_HOVER, 0);
+                break;
+            case SDL_MOUSEWHEEL:
+                tll_foreach(tMouseCtrl->tMouseHndBunch.sdlWheel, tBunch)
                     tBunch->item.fHnd(vRun, (struct tController*) tCtrl);
-            break;
-        default:
-            break;
+                // Wheel events carry no cursor position, so the current one is used.
+                SDL_GetMouseState(&mx, &my);
+                __vMouseDispatchTarget(vRun, tCtrl, mx, my, MOUSE_WHEEL, 0);
+                break;
+            default:
+                break;
+        }
     }
 }
 
@@ -226,27 +633,43 @@ void __vMouseControllerHandlerFn(void *vRun, tController *tCtrl) {
  *  @brief - append handler function for the mouse controller on press event.  
  * */
 void vMouseOnPress(tMouseController* tMouseCtrl, uint8_t sdlButton, tRect *tRct, fHandler fHnd) {
-    fMouseKeyBunch fPair = { .fHnd = fHnd, .sdlButton = sdlButton, .tRct = (struct tRect*)tRct };
-    tll_push_front(tMouseCtrl->tMouseHndBunch.sdlPressed, fPair);
+    fMouseKeyBunch fPair = { .fHnd = fHnd, .sdlButton = sdlButton, .tRct = NULL };
+
+    if (tRct != NULL)
+        __vMouseIndexBind(tMouseCtrl->tIndex, tRct, (tMouseBinding) { tMouseCtrl, fHnd, MOUSE_PRESS, sdlButton });
+    else
+        tll_push_front(tMouseCtrl->tMouseHndBunch.sdlPressed, fPair);
 }
 /* 
  *  @brief - append handler function for the mouse controller on release event.  
  * */
 void vMouseOnRelease(tMouseController* tMouseCtrl, uint8_t sdlButton, tRect *tRct, fHandler fHnd) {
-    fMouseKeyBunch fPair = { .fHnd = fHnd, .sdlButton = sdlButton, .tRct = (struct tRect*)tRct };
-    tll_push_front(tMouseCtrl->tMouseHndBunch.sdlReleased, fPair);
+    fMouseKeyBunch fPair = { .fHnd = fHnd, .sdlButton = sdlButton, .tRct = NULL };
+
+    if (tRct != NULL)
+        __vMouseIndexBind(tMouseCtrl->tIndex, tRct, (tMouseBinding) { tMouseCtrl, fHnd, MOUSE_RELEASE, sdlButton });
+    else
+        tll_push_front(tMouseCtrl->tMouseHndBunch.sdlReleased, fPair);
 }
 /* 
  *  @brief - append handler function for the mouse controller on hover event.  
  * */
 void vMouseOnHover(tMouseController* tMouseCtrl, tRect *tRct, fHandler fHnd) {
-    fMouseBunch fPair = { .fHnd = fHnd, .tRct = (struct tRect*)tRct };
-    tll_push_front(tMouseCtrl->tMouseHndBunch.sdlHover, fPair);
+    fMouseBunch fPair = { .fHnd = fHnd, .tRct = NULL };
+
+    if (tRct != NULL)
+        __vMouseIndexBind(tMouseCtrl->tIndex, tRct, (tMouseBinding) { tMouseCtrl, fHnd, MOUSE_HOVER, 0 });
+    else
+        tll_push_front(tMouseCtrl->tMouseHndBunch.sdlHover, fPair);
 }
 /* 
  *  @brief - append handler function for the mouse controller on mousewheel event.  
  * */
 void vMouseOnWheel(tMouseController* tMouseCtrl, tRect *tRct, fHandler fHnd) {
-    fMouseBunch fPair = { .fHnd = fHnd, .tRct = (struct tRect*)tRct };
-    tll_push_front(tMouseCtrl->tMouseHndBunch.sdlWheel, fPair);
+    fMouseBunch fPair = { .fHnd = fHnd, .tRct = NULL };
+
+    if (tRct != NULL)
+        __vMouseIndexBind(tMouseCtrl->tIndex, tRct, (tMouseBinding) { tMouseCtrl, fHnd, MOUSE_WHEEL, 0 });
+    else
+        tll_push_front(tMouseCtrl->tMouseHndBunch.sdlWheel, fPair);
 }
@@ -24,32 +24,118 @@
  *
  * */
 
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
 #include "tllist.h"
 #include <SDL_ttf.h>
 #include <log.h>
 #include <rect.h>
 #include <font.h>
 #include <runtime.h>
+#include <glyph.h>
 #include <intrinsics.h>
+#include <trace.h>
 
 // Function to convert sString to char*
 char* sStringToCharPtr(const sString* sStr) {
     if (!sStr) 
         return NULL;
 
-    size_t length = tll_length(*sStr);
-    if (length == 0)
-        return strdup("");
+    return strndup(sStringData(sStr), sStr->uLength);
+}
 
-    char* result = (char*)malloc(length + 1);
-    if (!result)
-        return NULL;
-    size_t i = 0;
-    tll_foreach(*sStr, item)
-        result[i++] = *(char*)item;
-    result[length] = '\0';
+/* 
+ *  @brief - appends one byte to the string in amortized O(1). Returns false if out of memory.
+ * */
+bool bStringPush(sString *sStr, char cChar) {
+    char *sData;
+
+    // One byte is always kept for the terminator.
+    if (sStr->uCapacity == 0 && sStr->uLength + 1 == __FEATHER_STRING_INLINE) {
+        sData = malloc(__FEATHER_STRING_INLINE * 2);
+        if (sData == NULL)
+            return false;
+        memcpy(sData, sStr->sInline, sStr->uLength);
+        sStr->sHeap = sData;
+        sStr->uCapacity = __FEATHER_STRING_INLINE * 2;
+    } else if (sStr->uCapacity && sStr->uLength + 1 == sStr->uCapacity) {
+        sData = realloc(sStr->sHeap, sStr->uCapacity * 2);
+        if (sData == NULL)
+            return false;
+        sStr->sHeap = sData;
+        sStr->uCapacity *= 2;
+    }
+
+    sData = sStr->uCapacity ? sStr->sHeap : sStr->sInline;
+    sData[sStr->uLength++] = cChar;
+    sData[sStr->uLength] = '\0';
+    return true;
+}
+
+/* 
+ *  @brief - removes the last byte of the string. Returns '\0' when the string is empty.
+ * */
+char cStringPop(sString *sStr) {
+    char *sData = sStr->uCapacity ? sStr->sHeap : sStr->sInline;
+    char c;
+
+    if (sStr->uLength == 0)
+        return '\0';
+
+    c = sData[--sStr->uLength];
+    sData[sStr->uLength] = '\0';
+    return c;
+}
+
+/* 
+ *  @brief - frees the heap buffer of the string, leaving an empty one.
+ * */
+void vStringFree(sString *sStr) {
+    if (sStr->uCapacity)
+        free(sStr->sHeap);
+    *sStr = (sString) {0};
+}
+
+/* Resizes the text's rect to the laid out glyphs. */
+static void __vTextRefreshRect(tRect *tRct) {
+    tGlyphRun *tGr = tRct->tGlyphs;
 
-    return result;
+    tRct->tFr.uIdx = 0;
+    tRct->tFr.uWidth = tRct->uTexWidth = (uint32_t)ceilf(tGr->fPenX);
+    tRct->tFr.uHeight = tRct->uTexHeight = tGr->tAtlas->iHeight;
+
+    // Texts are sorted next to other rects sampling the same page, so they share the draw call.
+    tRct->idTextureID = tGr->tAtlas->uPages ? (uintptr_t)tGr->tAtlas->sdlPages[0] : 0;
+    __vRectRefreshFrame(tRct);
+}
+
+/* Arguments of the glyph calls, which may upload atlas pages and therefore run on the render thread. */
+typedef struct {
+    tRuntime *tRun;
+    tGlyphRun *tGlyphs;
+    const char *sData;
+    uint32_t uLength;
+} __tTextGlyphCall;
+
+static void __vTextPushGlyphs(void *vArg) {
+    __tTextGlyphCall *tCall = vArg;
+    for (uint32_t i = 0; i < tCall->uLength; ++i)
+        bGlyphRunPush(tCall->tGlyphs, tCall->tRun->sdlRenderer, tCall->sData[i]);
+}
+
+/* Lays out the whole string again, only needed once the font changes. */
+static void __vTextLayout(tRuntime *tRun, tText *tTxt, tRect *tRct) {
+    __tTextGlyphCall tCall = { 
+        .tRun = tRun, 
+        .tGlyphs = tRct->tGlyphs, 
+        .sData = sStringData(&tTxt->sStr), 
+        .uLength = tTxt->sStr.uLength,
+    };
+
+    vGlyphRunClear(tRct->tGlyphs);
+    vRenderThreadCall(tRun->tRender, __vTextPushGlyphs, &tCall);
+    __vTextRefreshRect(tRct);
 }
 
 /* 
@@ -64,10 +150,21 @@ char* sStringToCharPtr(const sString* sStr) {
  * */
 tText* tTextInit(tRuntime *tRun, tText *tTxt, const char *sInitText, tContext2D tCtx, const char *sFontPath, uint16_t uPriority) {
     tRuntime *_tRun = (tRuntime*) tRun;
-    TTF_Font *sdlFont = TTF_OpenFont(sFontPath, 24);
+    FEATHER_TRACE_BEGIN(uStart);
+
+    if (!strlen(sInitText)) {
+        vFeatherLogError("Zero length texts are not allowed.");
+        return NULL;
+    }
+
+    tGlyphAtlas *tAtlas = tGlyphAtlasAcquire(&_tRun->tGlyphs, sFontPath, 24);
+    if (tAtlas == NULL)
+        return NULL;
 
-    if (sdlFont == NULL) {
-        vFeatherLogError("Unable to append font: %s. %s", strrchr(sFontPath, '/') + 1, TTF_GetError());
+    tGlyphRun *tGr = tGlyphRunCreate(tAtlas);
+    if (tGr == NULL) {
+        vFeatherLogError("Unable to allocate text glyphs.");
+        vGlyphAtlasRelease(&_tRun->tGlyphs, tAtlas);
         return NULL;
     }
 
@@ -75,33 +172,30 @@ tText* tTextInit(tRuntime *tRun, tText *tTxt, const char *sInitText, tContext2D
         .tAnims = tll_init(), 
         .tCtx = tCtx, 
         .sTexturePath = "TTEXT",
+        .sdlColor = __FEATHER__WHITE__,
+        .uPriority = uPriority,
         .tFr.uIdx = 0,
-        .uRectId = uRectIDIncrementer,
+        .tGlyphs = tGr,
     };
 
-    tTxt->uRectID = tRct.uRectId;
-
-    if (!strlen(sInitText)) {
-        vFeatherLogError("Zero length texts are not allowed.");
+    tRect *tStored = tRectPoolInsert(&_tRun->sScene->tRects, tRct);
+    if (tStored == NULL) {
+        vGlyphRunFree(tGr);
+        vGlyphAtlasRelease(&_tRun->tGlyphs, tAtlas);
         return NULL;
     }
-
-    // Insert the rectangle into the list with priority handling
-    tll_foreach(_tRun->sScene->lRects, it) {
-        if (it->item.uPriority > uPriority) {
-            tll_insert_before(_tRun->sScene->lRects, it, tRct);
-        }
-    }
-
-    // New higher priority rectangles are pushed to the front
-    tll_push_back(_tRun->sScene->lRects, tRct);
+    tTxt->uRectID = tStored->uRectId;
 
     tTxt->uFontSize = 24;
     tTxt->uLength = 0;
-    tTxt->sdlFont = sdlFont;
+    tTxt->sdlFont = tAtlas->sdlFont;
     tTxt->sFontPath = sFontPath;
+
+    // Already written content is kept, the new rect starts out with it.
+    __vTextLayout(tRun, tTxt, tStored);
     vTextAppend(tRun, tTxt, (char*)sInitText);
 
+    FEATHER_TRACE_END(uStart, "asset", "tTextInit %s", sFontPath);
     return tTxt; 
 }
 
@@ -110,70 +204,69 @@ tText* tTextInit(tRuntime *tRun, tText *tTxt, const char *sInitText, tContext2D
  * */
 void vChangeTextFont(tRuntime* tRun, tText* tTxt, const char* sNewFontPath, uint16_t uNewFontSize) {
     tRect *tRct;
+    FEATHER_TRACE_BEGIN(uStart);
     tRct = tGetRect(tRun, tTxt->uRectID);
 
-    if (tRct == NULL) {
+    if (tRct == NULL || tRct->tGlyphs == NULL) {
         vFeatherLogError("Unable to get text's Rect. Make sure that it is initialized.");
         return;
     }
 
     if (sNewFontPath != NULL || tTxt->uFontSize != uNewFontSize) {
-        TTF_Font* oldFont = tTxt->sdlFont;
-        if (oldFont) {
-            TTF_CloseFont(oldFont);
-            tTxt->sdlFont = NULL;
-        }
-
         sNewFontPath = (sNewFontPath == NULL) ? tTxt->sFontPath : sNewFontPath;
-        TTF_Font* newFont = TTF_OpenFont(sNewFontPath, uNewFontSize);
-        if (!newFont) {
-            vFeatherLogError("Unable to load new font: %s", TTF_GetError());
+
+        // Acquiring before releasing, so the atlas survives when only the path is repeated.
+        tGlyphAtlas *tAtlas = tGlyphAtlasAcquire(&tRun->tGlyphs, sNewFontPath, uNewFontSize);
+        if (tAtlas == NULL) {
+            vFeatherLogError("Unable to load new font: %s", sNewFontPath);
             return;
         }
 
-        tTxt->sdlFont = newFont;
+        vGlyphAtlasRelease(&tRun->tGlyphs, tRct->tGlyphs->tAtlas);
+        tRct->tGlyphs->tAtlas = tAtlas;
+        tTxt->sdlFont = tAtlas->sdlFont;
+        tTxt->sFontPath = sNewFontPath;
         tTxt->uFontSize = uNewFontSize;
     }
 
-    SDL_Surface* sdlSurf = TTF_RenderUTF8(tTxt->sdlFont, sStringToCharPtr(&tTxt->sStr), __FEATHER__WHITE__, __FEATHER__BLACK__);
-    tRct->tFr.uWidth = sdlSurf->w; 
-    tRct->tFr.uHeight = sdlSurf->h;
-    if (!sdlSurf) {
-        vFeatherLogError("Unable to render text surface: %s", TTF_GetError());
-        TTF_CloseFont(tTxt->sdlFont); // Clean up on error
-        tTxt->sdlFont = NULL;
-        return;
-    }
-
-    SDL_Texture* textTexture = SDL_CreateTextureFromSurface(tRun->sdlRenderer, sdlSurf);
-    SDL_FreeSurface(sdlSurf);
-    if (!textTexture) {
-        vFeatherLogError("Unable to create text texture: %s", SDL_GetError());
-        TTF_CloseFont(tTxt->sdlFont);
-        tTxt->sdlFont = NULL;
-        return;
-    }
-
-    tRct->idTextureID = (uintptr_t)textTexture;
+    __vTextLayout(tRun, tTxt, tRct);
+    FEATHER_TRACE_END(uStart, "asset", "vChangeTextFont %u", tTxt->uFontSize);
 }
 
 void __vInnerAppendCharUpdate(tRuntime *tRun, tText *tTxt, char cChar, bool bUpdate) {
+    tRect *tRct = tGetRect(tRun, tTxt->uRectID);
+
     if (cChar != '\0' && cChar != '\n') {
-        tll_push_back(tTxt->sStr, cChar);
+        if (!bStringPush(&tTxt->sStr, cChar)) {
+            vFeatherLogError("Unable to grow the text.");
+            return;
+        }
         tTxt->uLength++;
-        if (bUpdate)
-            vChangeTextFont(tRun, tTxt, NULL, tTxt->uFontSize);
+
+        // Only the new glyph is laid out, the rest of the text stays untouched.
+        if (tRct != NULL && tRct->tGlyphs != NULL) {
+            __tTextGlyphCall tCall = { .tRun = tRun, .tGlyphs = tRct->tGlyphs, .sData = &cChar, .uLength = 1 };
+            vRenderThreadCall(tRun->tRender, __vTextPushGlyphs, &tCall);
+        }
     }
+
+    if (bUpdate && tRct != NULL && tRct->tGlyphs != NULL)
+        __vTextRefreshRect(tRct);
 }
 
 char __vInnerPopCharUpdate(tRuntime *tRun, tText *tTxt, bool bUpdate) {
+    tRect *tRct = tGetRect(tRun, tTxt->uRectID);
     char c = '\0';
-    if (tll_length(tTxt->sStr) - 1) {
-        c = tll_pop_back(tTxt->sStr);
+
+    if (tTxt->sStr.uLength > 1) {
+        c = cStringPop(&tTxt->sStr);
         tTxt->uLength--;
+        if (tRct != NULL && tRct->tGlyphs != NULL)
+            vGlyphRunPop(tRct->tGlyphs);
     }
-    if (bUpdate)
-        vChangeTextFont(tRun, tTxt, NULL, tTxt->uFontSize);
+
+    if (bUpdate && tRct != NULL && tRct->tGlyphs != NULL)
+        __vTextRefreshRect(tRct);
     return c;
 }
 
@@ -217,3 +310,20 @@ void vTextAppend(tRuntime *tRun, tText *tTxt, char *sSlice) {
     if (*sSlice)
         __vInnerAppendCharUpdate(tRun, tTxt, *sSlice, true);
 }
+
+/* 
+ *  @brief - removes the text's rect from the current scene and frees the text string.
+ *
+ *  The text shall be initialized again before any further use.
+ * */
+void vTextFree(tRuntime *tRun, tText *tTxt) {
+    tRect *tRct = tGetRect(tRun, tTxt->uRectID);
+
+    // The rect releases the glyph run and the atlas reference together with itself.
+    if (tRct != NULL)
+        vDestroyRect(tRun, tRct);
+
+    vStringFree(&tTxt->sStr);
+    tTxt->uRectID = FEATHER_RECT_INVALID;
+    tTxt->uLength = 0;
+}
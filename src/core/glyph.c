@@ -0,0 +1,533 @@
+/**************************************************************************************************
+ *  File: glyph.c
+ *  Desc: Glyph atlases of the text renderer. Every font and size pair rasterizes each glyph once into
+ *  shared texture pages, and texts are drawn as runs of quads sampling these pages.
+ **************************************************************************************************
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ * */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glyph.h>
+#include <intrinsics.h>
+#include <log.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define __GLYPH_MMAP 1
+#else
+#define __GLYPH_MMAP 0
+#endif
+
+#define __GLYPH_ATLAS_INITIAL_CAPACITY 4
+#define __GLYPH_FILE_INITIAL_CAPACITY 4
+#define __GLYPH_EXTRA_INITIAL_CAPACITY 64
+#define __GLYPH_RUN_INITIAL_CAPACITY 32
+
+/* Glyphs are padded by one transparent pixel, so filtering never samples the neighbouring glyph. */
+#define __GLYPH_PADDING 1
+
+static void __vGlyphPageDestroy(tGlyphCache *tCache, SDL_Texture *sdlPage) {
+    if (tCache->fDestroy != NULL)
+        tCache->fDestroy(tCache->vDestroyCtx, sdlPage);
+    else
+        SDL_DestroyTexture(sdlPage);
+}
+
+/* Maps the whole file read-only, falling back to reading it into memory. */
+static bool __bFontFileLoad(tFontFile *tFile) {
+#if __GLYPH_MMAP
+    struct stat sSt;
+    int iFd = open(tFile->sPath, O_RDONLY);
+
+    if (iFd >= 0 && fstat(iFd, &sSt) == 0 && sSt.st_size > 0) {
+        void *vData = mmap(NULL, sSt.st_size, PROT_READ, MAP_PRIVATE, iFd, 0);
+        if (vData != MAP_FAILED) {
+            tFile->vData = vData;
+            tFile->uSize = sSt.st_size;
+            tFile->bMapped = true;
+        }
+    }
+
+    if (iFd >= 0)
+        close(iFd);
+    if (tFile->bMapped)
+        return true;
+#endif
+
+    tFile->vData = SDL_LoadFile(tFile->sPath, &tFile->uSize);
+    return tFile->vData != NULL;
+}
+
+static tFontFile* __tFontFileAcquire(tGlyphCache *tCache, const char *sPath) {
+    tFontFile *tFile;
+
+    for (uint32_t i = 0; i < tCache->uFileCount; ++i)
+        if (strcmp(tCache->tFiles[i]->sPath, sPath) == 0) {
+            tCache->tFiles[i]->uRefCount++;
+            return tCache->tFiles[i];
+        }
+
+    if (tCache->uFileCount == tCache->uFileCapacity) {
+        uint32_t uNewCapacity = tCache->uFileCapacity ? tCache->uFileCapacity * 2 : __GLYPH_FILE_INITIAL_CAPACITY;
+        tFontFile **tFiles = realloc(tCache->tFiles, uNewCapacity * sizeof(tFontFile*));
+        if (tFiles == NULL)
+            return NULL;
+        tCache->tFiles = tFiles;
+        tCache->uFileCapacity = uNewCapacity;
+    }
+
+    tFile = calloc(1, sizeof(tFontFile));
+    if (tFile == NULL)
+        return NULL;
+
+    tFile->sPath = strdup(sPath);
+    if (tFile->sPath == NULL || !__bFontFileLoad(tFile)) {
+        free(tFile->sPath);
+        free(tFile);
+        return NULL;
+    }
+
+    tFile->uRefCount = 1;
+    tCache->tFiles[tCache->uFileCount++] = tFile;
+    return tFile;
+}
+
+static void __vFontFileRelease(tGlyphCache *tCache, tFontFile *tFile) {
+    if (--tFile->uRefCount)
+        return;
+
+    for (uint32_t i = 0; i < tCache->uFileCount; ++i)
+        if (tCache->tFiles[i] == tFile) {
+            tCache->tFiles[i] = tCache->tFiles[--tCache->uFileCount];
+            break;
+        }
+
+#if __GLYPH_MMAP
+    if (tFile->bMapped)
+        munmap(tFile->vData, tFile->uSize);
+    else
+#endif
+        SDL_free(tFile->vData);
+
+    free(tFile->sPath);
+    free(tFile);
+}
+
+static void __vGlyphAtlasDestroy(tGlyphCache *tCache, tGlyphAtlas *tAtlas, bool bDefer) {
+    for (uint32_t i = 0; i < tAtlas->uPages; ++i)
+        if (bDefer)
+            __vGlyphPageDestroy(tCache, tAtlas->sdlPages[i]);
+        else
+            SDL_DestroyTexture(tAtlas->sdlPages[i]);
+
+    // The font reads from the file's memory, so it is closed first.
+    TTF_CloseFont(tAtlas->sdlFont);
+    __vFontFileRelease(tCache, tAtlas->tFile);
+    free(tAtlas->sdlPages);
+    free(tAtlas->tExtra);
+    free(tAtlas->sPath);
+    free(tAtlas);
+}
+
+/* Fibonacci hashing of the codepoint. */
+static inline uint32_t __uGlyphHash(uint32_t uCodepoint) {
+    return uCodepoint * 2654435761u;
+}
+
+static tGlyphEntry* __tGlyphExtraSlot(tGlyphEntry *tExtra, uint32_t uCapacity, uint32_t uCodepoint) {
+    uint32_t uMask = uCapacity - 1;
+    uint32_t uSlot = __uGlyphHash(uCodepoint) & uMask;
+
+    while (tExtra[uSlot].uCodepoint != 0 && tExtra[uSlot].uCodepoint != uCodepoint)
+        uSlot = (uSlot + 1) & uMask;
+
+    return &tExtra[uSlot];
+}
+
+static int __iGlyphExtraGrow(tGlyphAtlas *tAtlas) {
+    uint32_t uNewCapacity = tAtlas->uExtraCapacity ? tAtlas->uExtraCapacity * 2 : __GLYPH_EXTRA_INITIAL_CAPACITY;
+    tGlyphEntry *tNew = calloc(uNewCapacity, sizeof(tGlyphEntry));
+    if (tNew == NULL)
+        return -1;
+
+    for (uint32_t i = 0; i < tAtlas->uExtraCapacity; ++i)
+        if (tAtlas->tExtra[i].uCodepoint != 0)
+            *__tGlyphExtraSlot(tNew, uNewCapacity, tAtlas->tExtra[i].uCodepoint) = tAtlas->tExtra[i];
+
+    free(tAtlas->tExtra);
+    tAtlas->tExtra = tNew;
+    tAtlas->uExtraCapacity = uNewCapacity;
+    return 0;
+}
+
+/* Returns the glyph's slot, inserting an unloaded one if the codepoint is not known yet. */
+static tGlyph* __tGlyphSlot(tGlyphAtlas *tAtlas, uint32_t uCodepoint) {
+    tGlyphEntry *tEntry;
+
+    if (uCodepoint < 128)
+        return &tAtlas->tAscii[uCodepoint];
+
+    // Keeping the load factor under 3/4 so probing sequences stay short.
+    if ((tAtlas->uExtraCount + 1) * 4 > tAtlas->uExtraCapacity * 3 && __iGlyphExtraGrow(tAtlas) < 0)
+        return NULL;
+
+    tEntry = __tGlyphExtraSlot(tAtlas->tExtra, tAtlas->uExtraCapacity, uCodepoint);
+    if (tEntry->uCodepoint == 0) {
+        tEntry->uCodepoint = uCodepoint;
+        tAtlas->uExtraCount++;
+    }
+
+    return &tEntry->tGl;
+}
+
+static int __iGlyphAtlasAddPage(tGlyphAtlas *tAtlas, SDL_Renderer *sdlRend) {
+    SDL_Texture **sdlPages = realloc(tAtlas->sdlPages, (tAtlas->uPages + 1) * sizeof(SDL_Texture*));
+    if (sdlPages == NULL)
+        return -1;
+    tAtlas->sdlPages = sdlPages;
+
+    SDL_Texture *sdlPage = SDL_CreateTexture(sdlRend, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 
+            FEATHER_GLYPH_PAGE_SIZE, FEATHER_GLYPH_PAGE_SIZE);
+    if (sdlPage == NULL) {
+        vFeatherLogError("Unable to create glyph atlas page: %s", SDL_GetError());
+        return -1;
+    }
+
+    // Content of new textures is undefined, while the padding around glyphs must stay transparent.
+    uint32_t *uPixels = calloc(FEATHER_GLYPH_PAGE_SIZE * FEATHER_GLYPH_PAGE_SIZE, sizeof(uint32_t));
+    if (uPixels == NULL) {
+        SDL_DestroyTexture(sdlPage);
+        return -1;
+    }
+    SDL_UpdateTexture(sdlPage, NULL, uPixels, FEATHER_GLYPH_PAGE_SIZE * sizeof(uint32_t));
+    SDL_SetTextureBlendMode(sdlPage, SDL_BLENDMODE_BLEND);
+    free(uPixels);
+
+    tAtlas->sdlPages[tAtlas->uPages++] = sdlPage;
+    tAtlas->uPenX = tAtlas->uPenY = tAtlas->uShelf = 0;
+    return 0;
+}
+
+/* Finds room for the glyph with a shelf packer, starting a new page once the last one is full. */
+static int __iGlyphAtlasPack(tGlyphAtlas *tAtlas, SDL_Renderer *sdlRend, int iW, int iH, tGlyph *tGl) {
+    uint32_t uW = iW + __GLYPH_PADDING, uH = iH + __GLYPH_PADDING;
+
+    if (uW > FEATHER_GLYPH_PAGE_SIZE || uH > FEATHER_GLYPH_PAGE_SIZE)
+        return -1;
+
+    if (tAtlas->uPages && tAtlas->uPenX + uW > FEATHER_GLYPH_PAGE_SIZE) {
+        tAtlas->uPenY += tAtlas->uShelf;
+        tAtlas->uPenX = 0;
+        tAtlas->uShelf = 0;
+    }
+
+    if ((tAtlas->uPages == 0 || tAtlas->uPenY + uH > FEATHER_GLYPH_PAGE_SIZE) && __iGlyphAtlasAddPage(tAtlas, sdlRend) < 0)
+        return -1;
+
+    tGl->sdlSrc = (SDL_Rect) { tAtlas->uPenX, tAtlas->uPenY, iW, iH };
+    tGl->uPage = tAtlas->uPages - 1;
+    tAtlas->uPenX += uW;
+    if (uH > tAtlas->uShelf)
+        tAtlas->uShelf = uH;
+
+    return 0;
+}
+
+/* 
+ *  @brief - obtains the atlas of the font and size pair, opening the font on the first request.
+ *
+ *  Increments the reference count of the atlas. Returns NULL if the font can't be opened. The font file is
+ *  memory-mapped once and shared by all sizes, which are opened from it with TTF_OpenFontRW.
+ * */
+tGlyphAtlas* tGlyphAtlasAcquire(tGlyphCache *tCache, const char *sPath, uint16_t uSize) {
+    const char *sName = strrchr(sPath, '/');
+    tGlyphAtlas *tAtlas;
+
+    for (uint32_t i = 0; i < tCache->uCount; ++i)
+        if (tCache->tAtlases[i]->uSize == uSize && strcmp(tCache->tAtlases[i]->sPath, sPath) == 0) {
+            tCache->tAtlases[i]->uRefCount++;
+            return tCache->tAtlases[i];
+        }
+
+    if (tCache->uCount == tCache->uCapacity) {
+        uint32_t uNewCapacity = tCache->uCapacity ? tCache->uCapacity * 2 : __GLYPH_ATLAS_INITIAL_CAPACITY;
+        tGlyphAtlas **tAtlases = realloc(tCache->tAtlases, uNewCapacity * sizeof(tGlyphAtlas*));
+        if (tAtlases == NULL) {
+            vFeatherLogError("Unable to grow the glyph cache.");
+            return NULL;
+        }
+        tCache->tAtlases = tAtlases;
+        tCache->uCapacity = uNewCapacity;
+    }
+
+    tFontFile *tFile = __tFontFileAcquire(tCache, sPath);
+    if (tFile == NULL) {
+        vFeatherLogError("Unable to load font file: %s", sName ? sName + 1 : sPath);
+        return NULL;
+    }
+
+    // The memory stream is closed together with the font, the file itself stays shared.
+    SDL_RWops *sdlRw = SDL_RWFromConstMem(tFile->vData, (int)tFile->uSize);
+    TTF_Font *sdlFont = sdlRw ? TTF_OpenFontRW(sdlRw, 1, uSize) : NULL;
+    if (sdlFont == NULL) {
+        vFeatherLogError("Unable to open font: %s. %s", sName ? sName + 1 : sPath, TTF_GetError());
+        __vFontFileRelease(tCache, tFile);
+        return NULL;
+    }
+
+    tAtlas = calloc(1, sizeof(tGlyphAtlas));
+    if (tAtlas == NULL || (tAtlas->sPath = strdup(sPath)) == NULL) {
+        vFeatherLogError("Unable to allocate glyph atlas.");
+        free(tAtlas);
+        TTF_CloseFont(sdlFont);
+        __vFontFileRelease(tCache, tFile);
+        return NULL;
+    }
+
+    tAtlas->uSize = uSize;
+    tAtlas->tFile = tFile;
+    tAtlas->sdlFont = sdlFont;
+    tAtlas->iHeight = TTF_FontHeight(sdlFont);
+    tAtlas->uRefCount = 1;
+    tCache->tAtlases[tCache->uCount++] = tAtlas;
+
+    vFeatherLogInfo("Loading asset: Font: %s (%u)...", sName ? sName + 1 : sPath, uSize);
+    return tAtlas;
+}
+
+/* 
+ *  @brief - drops one reference of the atlas. The last reference destroys it's pages and closes the font.
+ * */
+void vGlyphAtlasRelease(tGlyphCache *tCache, tGlyphAtlas *tAtlas) {
+    if (tAtlas == NULL || --tAtlas->uRefCount)
+        return;
+
+    for (uint32_t i = 0; i < tCache->uCount; ++i)
+        if (tCache->tAtlases[i] == tAtlas) {
+            tCache->tAtlases[i] = tCache->tAtlases[--tCache->uCount];
+            break;
+        }
+
+    __vGlyphAtlasDestroy(tCache, tAtlas, true);
+}
+
+/* 
+ *  @brief - returns the glyph of the codepoint, rasterizing it into the atlas on the first request.
+ *
+ *  The renderer must be locked by the caller. Returns NULL if the glyph can't be rasterized.
+ * */
+const tGlyph* tGlyphAtlasGet(tGlyphAtlas *tAtlas, SDL_Renderer *sdlRend, uint32_t uCodepoint) {
+    int iMinX, iMaxX, iMinY, iMaxY, iAdvance;
+    tGlyph *tGl = __tGlyphSlot(tAtlas, uCodepoint);
+
+    if (tGl == NULL || tGl->bLoaded)
+        return tGl;
+
+    if (TTF_GlyphMetrics32(tAtlas->sdlFont, uCodepoint, &iMinX, &iMaxX, &iMinY, &iMaxY, &iAdvance) < 0) {
+        vFeatherLogWarn("Unable to get metrics of glyph U+%04X: %s", uCodepoint, TTF_GetError());
+        return NULL;
+    }
+
+    // Rendered in white, so the rect's color tints it. Whitespace may have no pixels at all.
+    SDL_Surface *sdlSurf = TTF_RenderGlyph32_Blended(tAtlas->sdlFont, uCodepoint, __FEATHER__WHITE__);
+    if (sdlSurf != NULL && sdlSurf->w > 0 && sdlSurf->h > 0) {
+        if (__iGlyphAtlasPack(tAtlas, sdlRend, sdlSurf->w, sdlSurf->h, tGl) < 0) {
+            vFeatherLogWarn("Unable to pack glyph U+%04X into the atlas.", uCodepoint);
+            SDL_FreeSurface(sdlSurf);
+            return NULL;
+        }
+        SDL_UpdateTexture(tAtlas->sdlPages[tGl->uPage], &tGl->sdlSrc, sdlSurf->pixels, sdlSurf->pitch);
+    } else
+        tGl->sdlSrc = (SDL_Rect) {0};
+
+    if (sdlSurf != NULL)
+        SDL_FreeSurface(sdlSurf);
+
+    tGl->iAdvance = iAdvance;
+    tGl->bLoaded = true;
+    return tGl;
+}
+
+/* 
+ *  @brief - destroys all atlases regardless of their reference count.
+ * */
+void vGlyphCacheFree(tGlyphCache *tCache) {
+    for (uint32_t i = 0; i < tCache->uCount; ++i)
+        __vGlyphAtlasDestroy(tCache, tCache->tAtlases[i], false);
+
+    // Every file is held by an atlas, so all of them were released above.
+    free(tCache->tAtlases);
+    free(tCache->tFiles);
+    *tCache = (tGlyphCache) {0};
+}
+
+/* 
+ *  @brief - creates an empty run drawing glyphs of the atlas. Returns NULL if out of memory.
+ * */
+tGlyphRun* tGlyphRunCreate(tGlyphAtlas *tAtlas) {
+    tGlyphRun *tGr = calloc(1, sizeof(tGlyphRun));
+    if (tGr != NULL)
+        tGr->tAtlas = tAtlas;
+    return tGr;
+}
+
+/* Draws the completed character with the glyph of it's codepoint and moves the pen past it. */
+static void __vGlyphRunResolve(tGlyphRun *tGr, SDL_Renderer *sdlRend, tGlyphQuad *tLead) {
+    const tGlyph *tGl = tGlyphAtlasGet(tGr->tAtlas, sdlRend, tLead->uCodepoint);
+
+    tLead->fX = tGr->fPenX;
+    if (tGl == NULL)
+        return;
+
+    tLead->sdlPage = tGl->sdlSrc.w ? tGr->tAtlas->sdlPages[tGl->uPage] : NULL;
+    tLead->sdlSrc = tGl->sdlSrc;
+    tGr->fPenX += tGl->iAdvance;
+}
+
+/* 
+ *  @brief - lays out one more byte of the text in O(1). The renderer must be locked by the caller.
+ *
+ *  UTF-8 sequences are decoded on the go, the character is drawn once it's last byte arrives.
+ * */
+bool bGlyphRunPush(tGlyphRun *tGr, SDL_Renderer *sdlRend, char cByte) {
+    uint8_t uByte = (uint8_t)cByte, uNeed;
+    uint32_t uCodepoint;
+    tGlyphQuad *tQuad;
+
+    if (tGr->uCount == tGr->uCapacity) {
+        uint32_t uNewCapacity = tGr->uCapacity ? tGr->uCapacity * 2 : __GLYPH_RUN_INITIAL_CAPACITY;
+        tGlyphQuad *tQuads = realloc(tGr->tQuads, uNewCapacity * sizeof(tGlyphQuad));
+        if (tQuads == NULL)
+            return false;
+        tGr->tQuads = tQuads;
+        tGr->uCapacity = uNewCapacity;
+    }
+
+    tQuad = &tGr->tQuads[tGr->uCount];
+
+    // Continuation bytes complete the character started by the last lead byte.
+    if ((uByte & 0xC0) == 0x80 && tGr->uCount && tGr->tQuads[tGr->tQuads[tGr->uCount - 1].uLead].uNeed) {
+        tGlyphQuad *tLead = &tGr->tQuads[tGr->tQuads[tGr->uCount - 1].uLead];
+
+        *tQuad = (tGlyphQuad) { .fX = tGr->fPenX, .uLead = tGr->tQuads[tGr->uCount - 1].uLead };
+        tGr->uCount++;
+        tLead->uCodepoint = (tLead->uCodepoint << 6) | (uByte & 0x3F);
+        if (--tLead->uNeed == 0)
+            __vGlyphRunResolve(tGr, sdlRend, tLead);
+        return true;
+    }
+
+    if (uByte < 0x80) {
+        uNeed = 0;
+        uCodepoint = uByte;
+    } else if (uByte >= 0xC0 && uByte < 0xF8) {
+        uNeed = uByte >= 0xF0 ? 3 : uByte >= 0xE0 ? 2 : 1;
+        uCodepoint = uByte & (0x3F >> uNeed);
+    } else {
+        // Stray continuation bytes and invalid lead bytes are drawn as the replacement character.
+        uNeed = 0;
+        uCodepoint = 0xFFFD;
+    }
+
+    *tQuad = (tGlyphQuad) { .fX = tGr->fPenX, .uCodepoint = uCodepoint, .uNeed = uNeed, .uLead = tGr->uCount };
+    tGr->uCount++;
+    if (uNeed == 0)
+        __vGlyphRunResolve(tGr, sdlRend, tQuad);
+    return true;
+}
+
+/* 
+ *  @brief - removes the last byte of the text in O(1).
+ * */
+void vGlyphRunPop(tGlyphRun *tGr) {
+    tGlyphQuad *tQuad, *tLead;
+
+    if (tGr->uCount == 0)
+        return;
+
+    tQuad = &tGr->tQuads[--tGr->uCount];
+    tLead = &tGr->tQuads[tQuad->uLead];
+
+    // A complete character is always the last one drawn, so the pen moves back to it's start.
+    if (tLead->uNeed == 0)
+        tGr->fPenX = tLead->fX;
+
+    // Removing a continuation byte leaves the character incomplete again.
+    if (tQuad != tLead) {
+        tLead->sdlPage = NULL;
+        tLead->uCodepoint >>= 6;
+        tLead->uNeed++;
+    }
+}
+
+/* 
+ *  @brief - removes the whole text, keeping the quad array for the next layout.
+ * */
+void vGlyphRunClear(tGlyphRun *tGr) {
+    tGr->uCount = 0;
+    tGr->fPenX = 0.f;
+}
+
+/* 
+ *  @brief - frees the run. The atlas reference is not released. NULL is ignored.
+ * */
+void vGlyphRunFree(tGlyphRun *tGr) {
+    if (tGr == NULL)
+        return;
+
+    free(tGr->tQuads);
+    free(tGr);
+}
+
+/* 
+ *  @brief - records the i-th quad of the rect's glyph run as a draw command.
+ *
+ *  Quads are scaled with the rect and rotated around the center of the whole text.
+ * */
+tRenderCmd tGlyphRunCmd(const tRect *tRct, uint32_t i) {
+    const tGlyphQuad *tQuad = &tRct->tGlyphs->tQuads[i];
+    float fSx = tRct->tCtx.fScaleX, fSy = tRct->tCtx.fScaleY;
+    float fW = tQuad->sdlSrc.w * fSx, fH = tQuad->sdlSrc.h * fSy;
+    float fSin = sinf(tRct->tCtx.fRotation * (float)M_PI / 180.0f);
+    float fCos = cosf(tRct->tCtx.fRotation * (float)M_PI / 180.0f);
+
+    // Offset of the glyph's center from the text's center, rotated together with the text.
+    float fOx = (tQuad->fX + tQuad->sdlSrc.w * 0.5f - tRct->uTexWidth * 0.5f) * fSx;
+    float fOy = (tQuad->sdlSrc.h * 0.5f - tRct->uTexHeight * 0.5f) * fSy;
+    float fCx = tRct->tCtx.fX + tRct->uTexWidth * fSx * 0.5f + fOx * fCos - fOy * fSin;
+    float fCy = tRct->tCtx.fY + tRct->uTexHeight * fSy * 0.5f + fOx * fSin + fOy * fCos;
+
+    return (tRenderCmd) {
+        .sdlTexture = tQuad->sdlPage,
+        .sdlSrc = tQuad->sdlSrc,
+        .uTexWidth = FEATHER_GLYPH_PAGE_SIZE,
+        .uTexHeight = FEATHER_GLYPH_PAGE_SIZE,
+        .sdlDst = { fCx - fW * 0.5f, fCy - fH * 0.5f, fW, fH },
+        .fRotation = tRct->tCtx.fRotation,
+        .sdlColor = tRct->sdlColor,
+    };
+}
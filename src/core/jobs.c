@@ -0,0 +1,373 @@
+/**************************************************************************************************
+ *  File: jobs.c
+ *  Desc: Work-stealing job system. Each worker thread owns a Chase-Lev deque, jobs of a dependency
+ *  graph are pushed to it once all their predecessors finished, and idle workers steal from others.
+ **************************************************************************************************
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ * */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include <jobs.h>
+#include <intrinsics.h>
+#include <log.h>
+
+#define __JOB_DEQUE_MASK (__FEATHER_JOB_DEQUE_CAPACITY - 1)
+
+/* Index of the deque owned by the current thread. The thread running the graph owns the first one. */
+static _Thread_local uint32_t __uJobWorker = 0;
+
+struct __tJobWorkerArg {
+    tJobSystem *tJobs;
+    uint32_t uIdx;
+};
+
+static bool __bJobDequePush(tJobDeque *tDeque, tJobNode *tNode) {
+    long long iBottom = atomic_load_explicit(&tDeque->iBottom, memory_order_relaxed);
+    long long iTop = atomic_load_explicit(&tDeque->iTop, memory_order_acquire);
+
+    if (iBottom - iTop >= __FEATHER_JOB_DEQUE_CAPACITY)
+        return false;
+
+    atomic_store_explicit(&tDeque->tItems[iBottom & __JOB_DEQUE_MASK], tNode, memory_order_relaxed);
+    atomic_store_explicit(&tDeque->iBottom, iBottom + 1, memory_order_release);
+    return true;
+}
+
+static tJobNode* __tJobDequePop(tJobDeque *tDeque) {
+    long long iBottom = atomic_load_explicit(&tDeque->iBottom, memory_order_relaxed) - 1;
+    long long iTop;
+    tJobNode *tNode;
+
+    atomic_store_explicit(&tDeque->iBottom, iBottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    iTop = atomic_load_explicit(&tDeque->iTop, memory_order_relaxed);
+
+    if (iTop > iBottom) {
+        atomic_store_explicit(&tDeque->iBottom, iBottom + 1, memory_order_relaxed);
+        return NULL;
+    }
+
+    tNode = atomic_load_explicit(&tDeque->tItems[iBottom & __JOB_DEQUE_MASK], memory_order_relaxed);
+    if (iTop == iBottom) {
+        // Last item, racing with thieves for it.
+        if (!atomic_compare_exchange_strong_explicit(&tDeque->iTop, &iTop, iTop + 1, memory_order_seq_cst, memory_order_relaxed))
+            tNode = NULL;
+        atomic_store_explicit(&tDeque->iBottom, iBottom + 1, memory_order_relaxed);
+    }
+
+    return tNode;
+}
+
+static tJobNode* __tJobDequeSteal(tJobDeque *tDeque) {
+    long long iTop = atomic_load_explicit(&tDeque->iTop, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long long iBottom = atomic_load_explicit(&tDeque->iBottom, memory_order_acquire);
+
+    if (iTop >= iBottom)
+        return NULL;
+
+    tJobNode *tNode = atomic_load_explicit(&tDeque->tItems[iTop & __JOB_DEQUE_MASK], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&tDeque->iTop, &iTop, iTop + 1, memory_order_seq_cst, memory_order_relaxed))
+        return NULL;
+
+    return tNode;
+}
+
+/* Pushes the job to the deque of the current thread and wakes one sleeping thread to take it. */
+static bool __bJobQueue(tJobSystem *tJobs, tJobNode *tNode) {
+    if (!__bJobDequePush(&tJobs->tDeques[__uJobWorker], tNode))
+        return false;
+
+    SDL_SemPost(tJobs->sdlReady);
+    return true;
+}
+
+/* Runs the job and releases it's successors, which become ready once all their predecessors finished. */
+static void __vJobExecute(tJobSystem *tJobs, tJobNode *tNode) {
+    tJobGraph *tGraph = tNode->tGraph;
+
+    tNode->fFn(tGraph->vCtx, tNode->vArg);
+
+    for (uint32_t i = 0; i < tNode->uSuccessorCount; ++i) {
+        tJobNode *tNext = &tGraph->tNodes[tNode->uSuccessors[i]];
+        if (atomic_fetch_sub_explicit(&tNext->aPending, 1, memory_order_acq_rel) != 1)
+            continue;
+
+        // A full deque only happens with huge graphs, the job is then run right away.
+        if (!__bJobQueue(tJobs, tNext))
+            __vJobExecute(tJobs, tNext);
+    }
+
+    // The last job wakes all sleeping threads, so they notice the graph is finished.
+    if (atomic_fetch_sub_explicit(&tGraph->aRemaining, 1, memory_order_acq_rel) == 1)
+        for (uint32_t i = 0; i <= tJobs->uWorkers; ++i)
+            SDL_SemPost(tJobs->sdlReady);
+}
+
+/* Takes a job from the own deque, or steals one from the others. NULL means all deques were seen empty. */
+static tJobNode* __tJobFind(tJobSystem *tJobs) {
+    tJobNode *tNode = __tJobDequePop(&tJobs->tDeques[__uJobWorker]);
+    bool bContended = tNode == NULL;
+
+    while (tNode == NULL && bContended) {
+        bContended = false;
+        for (uint32_t i = 1; tNode == NULL && i <= tJobs->uWorkers; ++i) {
+            tJobDeque *tDeque = &tJobs->tDeques[(__uJobWorker + i) % (tJobs->uWorkers + 1)];
+            tNode = __tJobDequeSteal(tDeque);
+
+            // Steals also fail when another thread took the item first, the deque is then visited again.
+            if (tNode == NULL && atomic_load_explicit(&tDeque->iTop, memory_order_acquire) < 
+                    atomic_load_explicit(&tDeque->iBottom, memory_order_acquire))
+                bContended = true;
+        }
+    }
+
+    return tNode;
+}
+
+/* Runs jobs until the graph is finished, sleeping whenever there is nothing to take. */
+static void __vJobHelp(tJobSystem *tJobs, tJobGraph *tGraph) {
+    while (atomic_load_explicit(&tGraph->aRemaining, memory_order_acquire) != 0) {
+        tJobNode *tNode = __tJobFind(tJobs);
+        if (tNode != NULL)
+            __vJobExecute(tJobs, tNode);
+        else
+            SDL_SemWait(tJobs->sdlReady);
+    }
+}
+
+static int __iJobWorker(void *vArg) {
+    struct __tJobWorkerArg tArg = *(struct __tJobWorkerArg*)vArg;
+    tJobSystem *tJobs = tArg.tJobs;
+    free(vArg);
+
+    __uJobWorker = tArg.uIdx;
+
+    for (;;) {
+        SDL_SemWait(tJobs->sdlWake);
+        if (!atomic_load_explicit(&tJobs->bRunning, memory_order_acquire))
+            break;
+
+        // The graph stays active until every wake-up of this run is answered by a done post.
+        tJobGraph *tGraph = atomic_load_explicit(&tJobs->tActive, memory_order_acquire);
+        if (tGraph != NULL)
+            __vJobHelp(tJobs, tGraph);
+        SDL_SemPost(tJobs->sdlDone);
+    }
+
+    return 0;
+}
+
+/* 
+ *  @brief - starts the worker threads. Zero workers picks one less than the amount of CPU cores.
+ *
+ *  Returns NULL if the system can't be created.
+ * */
+tJobSystem* tJobSystemCreate(uint32_t uWorkers) {
+    tJobSystem *tJobs = calloc(1, sizeof(tJobSystem));
+    if (tJobs == NULL)
+        return NULL;
+
+    if (uWorkers == 0)
+        uWorkers = SDL_GetCPUCount() > 1 ? SDL_GetCPUCount() - 1 : 0;
+
+    tJobs->tDeques = calloc(uWorkers + 1, sizeof(tJobDeque));
+    tJobs->sdlThreads = calloc(uWorkers ? uWorkers : 1, sizeof(SDL_Thread*));
+    tJobs->sdlWake = SDL_CreateSemaphore(0);
+    tJobs->sdlReady = SDL_CreateSemaphore(0);
+    tJobs->sdlDone = SDL_CreateSemaphore(0);
+    if (tJobs->tDeques == NULL || tJobs->sdlThreads == NULL || tJobs->sdlWake == NULL || 
+            tJobs->sdlReady == NULL || tJobs->sdlDone == NULL) {
+        vFeatherLogError("Unable to create the job system.");
+        vJobSystemFree(tJobs);
+        return NULL;
+    }
+
+    atomic_store(&tJobs->bRunning, true);
+    for (uint32_t i = 0; i < uWorkers; ++i) {
+        struct __tJobWorkerArg *tArg = malloc(sizeof(struct __tJobWorkerArg));
+        if (tArg == NULL)
+            break;
+        *tArg = (struct __tJobWorkerArg) { tJobs, i + 1 };
+
+        tJobs->sdlThreads[i] = SDL_CreateThread(__iJobWorker, "feather_job", tArg);
+        if (tJobs->sdlThreads[i] == NULL) {
+            vFeatherLogWarn("Unable to start a job worker: %s", SDL_GetError());
+            free(tArg);
+            break;
+        }
+        tJobs->uWorkers++;
+    }
+
+    vFeatherLogInfo("Job system started with %u workers.", tJobs->uWorkers);
+    return tJobs;
+}
+
+/* 
+ *  @brief - stops and joins all workers and frees the system. NULL is ignored.
+ * */
+void vJobSystemFree(tJobSystem *tJobs) {
+    if (tJobs == NULL)
+        return;
+
+    atomic_store(&tJobs->bRunning, false);
+    for (uint32_t i = 0; i < tJobs->uWorkers; ++i)
+        SDL_SemPost(tJobs->sdlWake);
+    for (uint32_t i = 0; i < tJobs->uWorkers; ++i)
+        SDL_WaitThread(tJobs->sdlThreads[i], NULL);
+
+    if (tJobs->sdlWake != NULL)
+        SDL_DestroySemaphore(tJobs->sdlWake);
+    if (tJobs->sdlReady != NULL)
+        SDL_DestroySemaphore(tJobs->sdlReady);
+    if (tJobs->sdlDone != NULL)
+        SDL_DestroySemaphore(tJobs->sdlDone);
+    free(tJobs->sdlThreads);
+    free(tJobs->tDeques);
+    free(tJobs);
+}
+
+/* 
+ *  @brief - adds a job to the graph. Returns it's index, or UINT32_MAX on failure.
+ * */
+uint32_t uJobGraphAdd(tJobGraph *tGraph, fJobFn fFn, void *vArg) {
+    if (tGraph->uCount == tGraph->uCapacity) {
+        uint32_t uNewCapacity = tGraph->uCapacity ? tGraph->uCapacity * 2 : 16;
+        tJobNode *tNodes = realloc(tGraph->tNodes, uNewCapacity * sizeof(tJobNode));
+        if (tNodes == NULL) {
+            vFeatherLogError("Unable to grow the job graph.");
+            return UINT32_MAX;
+        }
+        memset(&tNodes[tGraph->uCapacity], 0, (uNewCapacity - tGraph->uCapacity) * sizeof(tJobNode));
+        tGraph->tNodes = tNodes;
+        tGraph->uCapacity = uNewCapacity;
+    }
+
+    // Successor arrays of cleared jobs are reused.
+    tJobNode *tNode = &tGraph->tNodes[tGraph->uCount];
+    tNode->fFn = fFn;
+    tNode->vArg = vArg;
+    tNode->tGraph = tGraph;
+    tNode->uSuccessorCount = 0;
+    tNode->uDependencies = 0;
+    return tGraph->uCount++;
+}
+
+/* 
+ *  @brief - makes the job 'uAfter' wait until the job 'uBefore' finishes. Requires uBefore < uAfter.
+ *
+ *  Returns false if the dependency can't be stored, in which case the jobs must not be run concurrently.
+ * */
+bool bJobGraphDepend(tJobGraph *tGraph, uint32_t uBefore, uint32_t uAfter) {
+    tJobNode *tNode = &tGraph->tNodes[uBefore];
+
+    if (tNode->uSuccessorCount == tNode->uSuccessorCapacity) {
+        uint32_t uNewCapacity = tNode->uSuccessorCapacity ? tNode->uSuccessorCapacity * 2 : 4;
+        uint32_t *uSuccessors = realloc(tNode->uSuccessors, uNewCapacity * sizeof(uint32_t));
+        if (uSuccessors == NULL) {
+            vFeatherLogError("Unable to grow the job graph.");
+            return false;
+        }
+        tNode->uSuccessors = uSuccessors;
+        tNode->uSuccessorCapacity = uNewCapacity;
+    }
+
+    tNode->uSuccessors[tNode->uSuccessorCount++] = uAfter;
+    tGraph->tNodes[uAfter].uDependencies++;
+    return true;
+}
+
+/* 
+ *  @brief - runs all jobs of the graph and returns once all of them finished.
+ *
+ *  The calling thread executes jobs as well. Without a job system the graph is run serially in the
+ *  order the jobs were added, which always respects the dependencies.
+ * */
+void vJobGraphRun(tJobSystem *tJobs, tJobGraph *tGraph) {
+    if (tJobs == NULL || tJobs->uWorkers == 0 || tGraph->uCount < 2) {
+        for (uint32_t i = 0; i < tGraph->uCount; ++i)
+            tGraph->tNodes[i].fFn(tGraph->vCtx, tGraph->tNodes[i].vArg);
+        return;
+    }
+
+    // Posts left over from the previous run would only cause spurious wake-ups.
+    while (SDL_SemTryWait(tJobs->sdlReady) == 0)
+        ;
+
+    atomic_store_explicit(&tGraph->aRemaining, tGraph->uCount, memory_order_relaxed);
+    for (uint32_t i = 0; i < tGraph->uCount; ++i)
+        atomic_store_explicit(&tGraph->tNodes[i].aPending, tGraph->tNodes[i].uDependencies, memory_order_relaxed);
+
+    __uJobWorker = 0;
+    for (uint32_t i = 0; i < tGraph->uCount; ++i)
+        if (tGraph->tNodes[i].uDependencies == 0 && !__bJobQueue(tJobs, &tGraph->tNodes[i]))
+            __vJobExecute(tJobs, &tGraph->tNodes[i]);
+
+    atomic_store_explicit(&tJobs->tActive, tGraph, memory_order_release);
+    for (uint32_t i = 0; i < tJobs->uWorkers; ++i)
+        SDL_SemPost(tJobs->sdlWake);
+
+    __vJobHelp(tJobs, tGraph);
+
+    // The graph may be changed or freed once this returns, so waiting for workers still looking at it.
+    for (uint32_t i = 0; i < tJobs->uWorkers; ++i)
+        SDL_SemWait(tJobs->sdlDone);
+    atomic_store_explicit(&tJobs->tActive, NULL, memory_order_release);
+}
+
+/* 
+ *  @brief - removes the job added last, together with all dependencies on it. Ignored on an empty graph.
+ * */
+void vJobGraphPop(tJobGraph *tGraph) {
+    uint32_t uLast;
+
+    if (tGraph->uCount == 0)
+        return;
+
+    // Dependencies on the last job were the last ones added to each of it's predecessors.
+    uLast = --tGraph->uCount;
+    for (uint32_t i = 0; i < uLast; ++i) {
+        tJobNode *tNode = &tGraph->tNodes[i];
+        while (tNode->uSuccessorCount > 0 && tNode->uSuccessors[tNode->uSuccessorCount - 1] == uLast)
+            tNode->uSuccessorCount--;
+    }
+}
+
+/* 
+ *  @brief - removes all jobs from the graph, while keeping the memory.
+ * */
+void vJobGraphClear(tJobGraph *tGraph) {
+    tGraph->uCount = 0;
+}
+
+/* 
+ *  @brief - frees all memory held by the graph.
+ * */
+void vJobGraphFree(tJobGraph *tGraph) {
+    for (uint32_t i = 0; i < tGraph->uCapacity; ++i)
+        free(tGraph->tNodes[i].uSuccessors);
+
+    free(tGraph->tNodes);
+    *tGraph = (tJobGraph) {0};
+}
@@ -28,8 +28,46 @@
 #include <SDL_events.h>
 #include <feather.h>
 #include <math.h>
+#include <stdlib.h>
 #include <physics.h>
 
+#define __PHYSICS_INITIAL_CAPACITY 16
+
+static int __iPhysicsWorldGrow(tPhysicsWorld *tWorld) {
+    uint32_t uNewCapacity = tWorld->uCapacity ? tWorld->uCapacity * 2 : __PHYSICS_INITIAL_CAPACITY;
+
+// Every array of the world grows together.
+#define __PHYSICS_GROW(field)                                                   \
+    do {                                                                        \
+        void *vNew = realloc(tWorld->field, uNewCapacity * sizeof(*tWorld->field)); \
+        if (vNew == NULL)                                                       \
+            return -1;                                                          \
+        tWorld->field = vNew;                                                   \
+    } while (0)
+
+    __PHYSICS_GROW(tRects);
+    __PHYSICS_GROW(dX);
+    __PHYSICS_GROW(dY);
+    __PHYSICS_GROW(dW);
+    __PHYSICS_GROW(dH);
+    __PHYSICS_GROW(eBodyTypes);
+    __PHYSICS_GROW(uGroups);
+    __PHYSICS_GROW(uDelays);
+    __PHYSICS_GROW(uLastSteps);
+    __PHYSICS_GROW(uQueried);
+    __PHYSICS_GROW(uColliders);
+    __PHYSICS_GROW(tForces);
+    __PHYSICS_GROW(uContacts);
+    __PHYSICS_GROW(fHandlers);
+    __PHYSICS_GROW(vHandlersData);
+    __PHYSICS_GROW(uDead);
+    __PHYSICS_GROW(uFree);
+#undef __PHYSICS_GROW
+
+    tWorld->uCapacity = uNewCapacity;
+    return 0;
+}
+
 /* 
  *  @brief - handles the physical layer of the application for the chosen entity.
  *
@@ -40,32 +78,65 @@
  *  @uCollidersGroup    - group number, in which collisions are managed.
  * */
 void vPhysicsInit(tRuntime *tRun, tPhysController *tPhys, tRect *tRct, ePhysicalBodyType eBodyType, uint32_t uCollidersGroup) {
-    tController *tCtrl;
-
-    *tPhys = (tPhysController){
-        .tRct = tRct,
-        .eBodyType = eBodyType,
-        .eGravityDir = BOTTOM,
-        // Initial state of object is unchanged. Can be manually manipulated within the user space.
-        .tAdditionalForces = tll_init(),
-        .lCurrentlyCollides = tll_init(),
-        .uCollidersGroup = uCollidersGroup,
-    };
+    tPhysicsWorld *tWorld = tRun->sScene->tPhysics;
+    uint32_t uBody;
+
+    // Scenes without physics never allocate a world.
+    if (tWorld == NULL) {
+        tWorld = tRun->sScene->tPhysics = calloc(1, sizeof(tPhysicsWorld));
+        if (tWorld == NULL) {
+            vFeatherLogError("Unable to allocate the physics world.");
+            return;
+        }
+    }
 
-    tPhys->uCtrlId = tControllerInit(tRun, SDL_USEREVENT, tPhys, fControllerHandler(__vPhysicsControllerInternal));
-    tCtrl = tControllerGet(tRun, tPhys->uCtrlId);
-    tCtrl->invoke = true; // Physics controllers always invoke themselves.
+    // Slots of removed bodies are reused, so spawning and despawning doesn't grow the world.
+    if (tWorld->uFreeCount > 0) {
+        uBody = tWorld->uFree[--tWorld->uFreeCount];
+    } else {
+        if (tWorld->uCount == tWorld->uCapacity && __iPhysicsWorldGrow(tWorld) < 0) {
+            vFeatherLogError("Unable to grow the physics world.");
+            return;
+        }
+        uBody = tWorld->uCount++;
+    }
+
+    tWorld->tRects[uBody] = tRct;
+    tWorld->dX[uBody] = tRct->tCtx.fX;
+    tWorld->dY[uBody] = tRct->tCtx.fY;
+    tWorld->dW[uBody] = tRct->tCtx.fScaleX * tRct->tFr.uWidth;
+    tWorld->dH[uBody] = tRct->tCtx.fScaleY * tRct->tFr.uHeight;
+    tWorld->eBodyTypes[uBody] = eBodyType;
+    tWorld->uGroups[uBody] = uCollidersGroup;
+    tWorld->uDelays[uBody] = 0;
+    tWorld->uLastSteps[uBody] = 0;
+    tWorld->uQueried[uBody] = 0;
+    // Initial state of object is unchanged. Can be manually manipulated within the user space.
+    tWorld->tForces[uBody] = (tForcesList) tll_init();
+    tWorld->uContacts[uBody] = 0;
+    tWorld->fHandlers[uBody] = NULL;
+    tWorld->vHandlersData[uBody] = NULL;
 
     tColliderLabel tClbl = { 
-        .x = tRct->tCtx.fX, 
-        .y = tRct->tCtx.fY,
+        .x = tWorld->dX[uBody], 
+        .y = tWorld->dY[uBody],
         .uCollidersGroup = uCollidersGroup,
-        .w = tRct->tCtx.fScaleX * tRct->tFr.uWidth,
-        .h = tRct->tCtx.fScaleY * tRct->tFr.uHeight,
-        .uColliderId = tPhys->uCtrlId,
+        .w = tWorld->dW[uBody],
+        .h = tWorld->dH[uBody],
+        .uColliderId = uBody,
     };
     vFeatherLogInfo("Appending new collider for the current scene: %d", tClbl.uColliderId);
-    tll_push_front(tRun->sScene->lColliders, tClbl);
+    tWorld->uColliders[uBody] = uSpatialInsert(&tWorld->tSpatial, tClbl);
+
+    *tPhys = (tPhysController) { .tWorld = tWorld, .uBody = uBody };
+}
+
+/* 
+ *  @brief - changes the physical type of the body.
+ * */
+void vPhysicsSetBodyType(tPhysController *tPhys, ePhysicalBodyType eBodyType) {
+    if (tPhys->tWorld != NULL)
+        tPhys->tWorld->eBodyTypes[tPhys->uBody] = eBodyType;
 }
 
 /* 
@@ -76,10 +147,9 @@ void vPhysicsInit(tRuntime *tRun, tPhysController *tPhys, tRect *tRct, ePhysical
  *  @dDelay - amount of delay time between controller calls in milis.
  * */
 void vPhysicsSetDelay(tRuntime *tRun, tPhysController *tPhys, double dDelay) {
-    tController *tCtrl;
-    tCtrl = tControllerGet(tRun, tPhys->uCtrlId);
-    tPhys->uDelay = dDelay;
-    tCtrl->uDelay = dDelay;
+    (void)tRun;
+    if (tPhys->tWorld != NULL)
+        tPhys->tWorld->uDelays[tPhys->uBody] = dDelay;
 }
 
 int checkCollision(tColliderLabel a, tColliderLabel b) {
@@ -89,47 +159,259 @@ int checkCollision(tColliderLabel a, tColliderLabel b) {
              a.y >= b.y + b.h);   // A is completely below B
 }
 
+static inline uint32_t __uPhysicsPairHash(uint64_t uKey) {
+    uKey ^= uKey >> 33;
+    uKey *= 0xff51afd7ed558ccdull;
+    uKey ^= uKey >> 33;
+    return (uint32_t)uKey;
+}
+
+static int __iPhysicsPairsGrow(tPhysicsWorld *tWorld) {
+    tCollisionPair *tOld = tWorld->tPairs;
+    uint32_t uOldCapacity = tWorld->uPairCapacity;
+    uint32_t uNewCapacity = uOldCapacity ? uOldCapacity * 2 : __PHYSICS_INITIAL_CAPACITY;
+
+    tCollisionPair *tNew = calloc(uNewCapacity, sizeof(tCollisionPair));
+    if (tNew == NULL)
+        return -1;
 
-void __vPhysicsControllerInternal(void *vRun, tController *tCtrl) {
-    tCtrl->invoke = true; // self invoked.
-    tRuntime *tRun = (tRuntime*)vRun;
-    tPhysController *tPhys = (tPhysController*)tCtrl->vUserData;
-    tRect *tRct = tPhys->tRct;
+    for (uint32_t i = 0; i < uOldCapacity; ++i) {
+        if (tOld[i].uKey == 0)
+            continue;
 
-    tColliderLabel tCol;
-    tll_foreach(tRun->sScene->lColliders, tData) {
-        tCol = tData->item;
-        if (tData->item.uColliderId == tPhys->uCtrlId) {
-            tData->item.x = tPhys->tRct->tCtx.fX;
-            tData->item.y = tPhys->tRct->tCtx.fY;
-            tData->item.w = tPhys->tRct->tCtx.fScaleX * tPhys->tRct->tFr.uWidth;
-            tData->item.h = tPhys->tRct->tCtx.fScaleY * tPhys->tRct->tFr.uHeight;
-            break;
+        uint32_t uSlot = __uPhysicsPairHash(tOld[i].uKey) & (uNewCapacity - 1);
+        while (tNew[uSlot].uKey != 0)
+            uSlot = (uSlot + 1) & (uNewCapacity - 1);
+        tNew[uSlot] = tOld[i];
+    }
+
+    free(tOld);
+    tWorld->tPairs = tNew;
+    tWorld->uPairCapacity = uNewCapacity;
+    return 0;
+}
+
+static void __vPhysicsPushEvent(tPhysicsWorld *tWorld, uint64_t uKey, eCollisionState eState) {
+    if (tWorld->uEvents == tWorld->uEventCapacity) {
+        uint32_t uNewCapacity = tWorld->uEventCapacity ? tWorld->uEventCapacity * 2 : __PHYSICS_INITIAL_CAPACITY;
+        tCollisionEvent *tEvents = realloc(tWorld->tEvents, uNewCapacity * sizeof(tCollisionEvent));
+        if (tEvents == NULL) {
+            vFeatherLogError("Unable to grow the collision event queue.");
+            return;
         }
+        tWorld->tEvents = tEvents;
+        tWorld->uEventCapacity = uNewCapacity;
+    }
+
+    // Indices are stored incremented, so no valid pair has a zero key.
+    tWorld->tEvents[tWorld->uEvents++] = (tCollisionEvent) {
+        .uBodyA = (uint32_t)(uKey >> 32) - 1,
+        .uBodyB = (uint32_t)uKey - 1,
+        .eState = eState,
+    };
+}
+
+/* Marks the pair as overlapping within the current step, inserting it on the first contact. */
+static void __vPhysicsTouchPair(tPhysicsWorld *tWorld, uint32_t uA, uint32_t uB) {
+    uint64_t uKey;
+    uint32_t uSlot;
+
+    if (uA > uB) {
+        uint32_t uTmp = uA;
+        uA = uB;
+        uB = uTmp;
+    }
+    uKey = ((uint64_t)(uA + 1) << 32) | (uB + 1);
+
+    if ((tWorld->uPairs + 1) * 4 > tWorld->uPairCapacity * 3 && __iPhysicsPairsGrow(tWorld) < 0) {
+        vFeatherLogError("Unable to grow the collision pair cache.");
+        return;
+    }
+
+    uSlot = __uPhysicsPairHash(uKey) & (tWorld->uPairCapacity - 1);
+    while (tWorld->tPairs[uSlot].uKey != 0 && tWorld->tPairs[uSlot].uKey != uKey)
+        uSlot = (uSlot + 1) & (tWorld->uPairCapacity - 1);
+
+    if (tWorld->tPairs[uSlot].uKey == 0) {
+        tWorld->tPairs[uSlot] = (tCollisionPair) { .uKey = uKey, .uStep = tWorld->uStep };
+        tWorld->uPairs++;
+        tWorld->uContacts[uA]++;
+        tWorld->uContacts[uB]++;
+        __vPhysicsPushEvent(tWorld, uKey, COLLISION_ENTER);
+    } else if (tWorld->tPairs[uSlot].uStep != tWorld->uStep) {
+        // Pairs are found from both of their bodies, but reported once.
+        tWorld->tPairs[uSlot].uStep = tWorld->uStep;
+        __vPhysicsPushEvent(tWorld, uKey, COLLISION_STAY);
     }
+}
+
+/* Removes the pair in the slot with backward shift deletion, so no tombstones are left. */
+static void __vPhysicsRemovePair(tPhysicsWorld *tWorld, uint32_t uSlot) {
+    uint32_t uMask = tWorld->uPairCapacity - 1;
+
+    tWorld->tPairs[uSlot] = (tCollisionPair) {0};
+    tWorld->uPairs--;
 
-    switch (tPhys->eBodyType) {
-        case DYNAMIC:
-            // Each additional supplied force is applied to the rect and removed.
-            tll_foreach(tPhys->tAdditionalForces, tF) {
-                vApplyForce(tRct, &tF->item);
-                if (tF->item.iTimes == 0)
-                    tll_remove(tPhys->tAdditionalForces, tF);
-                else if (tF->item.iTimes > 0)
-                    tF->item.iTimes--;
-            }
-
-        case STATIC:
-            tll_foreach(tRun->sScene->lColliders, tData) {
-                tColliderLabel tCol2 = tData->item;
-                if (tCol2.uCollidersGroup == tPhys->uCollidersGroup) {
-                    if (tCol2.uColliderId != tCol.uColliderId && checkCollision(tCol, tCol2)) {
-                        tll_push_front(tPhys->lCurrentlyCollides, tCol2);
-                    }
-                }
-            }
-        case COLLIDER:
-            break;
+    for (uint32_t uNext = (uSlot + 1) & uMask; tWorld->tPairs[uNext].uKey != 0; uNext = (uNext + 1) & uMask) {
+        uint32_t uHome = __uPhysicsPairHash(tWorld->tPairs[uNext].uKey) & uMask;
+
+        if (((uNext - uHome) & uMask) >= ((uNext - uSlot) & uMask)) {
+            tWorld->tPairs[uSlot] = tWorld->tPairs[uNext];
+            tWorld->tPairs[uNext] = (tCollisionPair) {0};
+            uSlot = uNext;
+        }
+    }
+}
+
+/* True if the body has tested it's overlaps during the current step. */
+static inline bool __bPhysicsQueried(tPhysicsWorld *tWorld, uint32_t uBody) {
+    // Compared by step instead of ticks, since several steps may run within the same millisecond.
+    return tWorld->eBodyTypes[uBody] != COLLIDER && tWorld->uQueried[uBody] == tWorld->uStep;
+}
+
+/* 
+ *  @brief - steps every body within the world once.
+ *
+ *  Called by the runtime once per fixed update, before the controllers are handled.
+ * */
+void vPhysicsWorldStep(tPhysicsWorld *tWorld) {
+    uint32_t uNow = uSchedulerNowMs();
+    uint32_t *uCandidates, uCandidatesCount;
+
+    tWorld->uStep++;
+    tWorld->uEvents = 0;
+
+    // Integrating forces of all dynamic bodies, which are due to be stepped.
+    for (uint32_t i = 0; i < tWorld->uCount; ++i) {
+        if (tWorld->tRects[i] == NULL || tWorld->eBodyTypes[i] != DYNAMIC || tWorld->uLastSteps[i] + tWorld->uDelays[i] >= uNow)
+            continue;
+
+        // Each additional supplied force is applied to the rect and removed.
+        tll_foreach(tWorld->tForces[i], tF) {
+            vApplyForce(tWorld->tRects[i], &tF->item);
+            if (tF->item.iTimes == 0)
+                tll_remove(tWorld->tForces[i], tF);
+            else if (tF->item.iTimes > 0)
+                tF->item.iTimes--;
+        }
+    }
+
+    // Rects may have been moved by anyone, so all bounds are gathered before testing any pair.
+    for (uint32_t i = 0; i < tWorld->uCount; ++i) {
+        tRect *tRct = tWorld->tRects[i];
+        if (tRct == NULL)
+            continue;
+        tWorld->dX[i] = tRct->tCtx.fX;
+        tWorld->dY[i] = tRct->tCtx.fY;
+        tWorld->dW[i] = tRct->tCtx.fScaleX * tRct->tFr.uWidth;
+        tWorld->dH[i] = tRct->tCtx.fScaleY * tRct->tFr.uHeight;
+        vSpatialUpdate(&tWorld->tSpatial, tWorld->uColliders[i], tWorld->dX[i], tWorld->dY[i], tWorld->dW[i], tWorld->dH[i]);
+    }
+
+    for (uint32_t i = 0; i < tWorld->uCount; ++i) {
+        if (tWorld->tRects[i] == NULL || tWorld->eBodyTypes[i] == COLLIDER || tWorld->uLastSteps[i] + tWorld->uDelays[i] >= uNow)
+            continue;
+        tWorld->uLastSteps[i] = uNow;
+        tWorld->uQueried[i] = tWorld->uStep;
+
+        // Broadphase yields colliders of the same group within shared cells, checkCollision decides.
+        tColliderLabel *tCol = tSpatialLabel(&tWorld->tSpatial, tWorld->uColliders[i]);
+        uCandidatesCount = uSpatialQuery(&tWorld->tSpatial, tWorld->uColliders[i], &uCandidates);
+        for (uint32_t j = 0; j < uCandidatesCount; ++j) {
+            tColliderLabel *tCol2 = tSpatialLabel(&tWorld->tSpatial, uCandidates[j]);
+            if (checkCollision(*tCol, *tCol2))
+                __vPhysicsTouchPair(tWorld, i, tCol2->uColliderId);
+        }
+    }
+
+    // Pairs not seen within this step are gone, unless none of their bodies was tested at all.
+    // Pairs of removed bodies are always gone.
+    for (uint32_t uSlot = 0; uSlot < tWorld->uPairCapacity; ) {
+        tCollisionPair *tPair = &tWorld->tPairs[uSlot];
+        uint32_t uA = (uint32_t)(tPair->uKey >> 32) - 1, uB = (uint32_t)tPair->uKey - 1;
+
+        if (tPair->uKey == 0 || (tWorld->tRects[uA] != NULL && tWorld->tRects[uB] != NULL && 
+            (tPair->uStep == tWorld->uStep || (!__bPhysicsQueried(tWorld, uA) && !__bPhysicsQueried(tWorld, uB))))) {
+            ++uSlot;
+            continue;
+        }
+
+        __vPhysicsPushEvent(tWorld, tPair->uKey, COLLISION_EXIT);
+        tWorld->uContacts[uA]--;
+        tWorld->uContacts[uB]--;
+
+        // Another pair may be shifted into this slot, so it is examined again.
+        __vPhysicsRemovePair(tWorld, uSlot);
+    }
+
+    for (uint32_t i = 0; i < tWorld->uEvents; ++i) {
+        tCollisionEvent *tEv = &tWorld->tEvents[i];
+        if (tWorld->fHandlers[tEv->uBodyA] != NULL)
+            tWorld->fHandlers[tEv->uBodyA](tWorld->vHandlersData[tEv->uBodyA], tEv->uBodyA, tEv->uBodyB, tEv->eState);
+        if (tWorld->fHandlers[tEv->uBodyB] != NULL)
+            tWorld->fHandlers[tEv->uBodyB](tWorld->vHandlersData[tEv->uBodyB], tEv->uBodyB, tEv->uBodyA, tEv->eState);
+    }
+
+    // Pairs of the removed bodies were dropped above, so their slots are free to be reused.
+    while (tWorld->uDeadCount > 0)
+        tWorld->uFree[tWorld->uFreeCount++] = tWorld->uDead[--tWorld->uDeadCount];
+}
+
+/* 
+ *  @brief - frees the world and all of it's bodies.
+ * */
+void vPhysicsWorldFree(tPhysicsWorld *tWorld) {
+    if (tWorld == NULL)
+        return;
+
+    for (uint32_t i = 0; i < tWorld->uCount; ++i)
+        tll_free(tWorld->tForces[i]);
+
+    free(tWorld->tRects);
+    free(tWorld->dX);
+    free(tWorld->dY);
+    free(tWorld->dW);
+    free(tWorld->dH);
+    free(tWorld->eBodyTypes);
+    free(tWorld->uGroups);
+    free(tWorld->uDelays);
+    free(tWorld->uLastSteps);
+    free(tWorld->uQueried);
+    free(tWorld->uColliders);
+    free(tWorld->tForces);
+    free(tWorld->uContacts);
+    free(tWorld->fHandlers);
+    free(tWorld->vHandlersData);
+    free(tWorld->uDead);
+    free(tWorld->uFree);
+    free(tWorld->tPairs);
+    free(tWorld->tEvents);
+    vSpatialFree(&tWorld->tSpatial);
+    free(tWorld);
+}
+
+/* 
+ *  @brief - removes the body of the rect from the world. Ignored if the world is NULL or the rect has no body.
+ *
+ *  Must be called before the rect is destroyed. Indices of other bodies stay valid, and pairs of the removed
+ *  body are reported as exited on the next step. After that step the index may be reused by a new body.
+ * */
+void vPhysicsRemove(tPhysicsWorld *tWorld, tRect *tRct) {
+    if (tWorld == NULL)
+        return;
+
+    // Bodies are only removed together with their rects, so a linear scan is cheap enough.
+    for (uint32_t i = 0; i < tWorld->uCount; ++i) {
+        if (tWorld->tRects[i] != tRct)
+            continue;
+
+        tWorld->tRects[i] = NULL;
+        vSpatialRemove(&tWorld->tSpatial, tWorld->uColliders[i]);
+        tll_free(tWorld->tForces[i]);
+        tWorld->fHandlers[i] = NULL;
+        tWorld->vHandlersData[i] = NULL;
+        // Reused only after the next step drops it's pairs, so a new body never inherits them.
+        tWorld->uDead[tWorld->uDeadCount++] = i;
     }
 }
 
@@ -142,7 +424,8 @@ void __vPhysicsControllerInternal(void *vRun, tController *tCtrl) {
  *  The force is applied once, and removed after the first controller update.
  * */
 void vPhysicsApplyForce(tPhysController *tPhys, tForce tF) {
-    tll_push_front(tPhys->tAdditionalForces, tF);
+    if (tPhys->tWorld != NULL && tPhys->tWorld->tRects[tPhys->uBody] != NULL)
+        tll_push_front(tPhys->tWorld->tForces[tPhys->uBody], tF);
 }
 
 /* 
@@ -179,5 +462,38 @@ void vAppendForce(tForce *tMainForce, tForce *tForwardedForce) {
  *  @brief - returns true of something collides with a collider.
  * */
 bool bPhysicsCurrentlyCollides(tPhysController *tPhys) {
-    return tll_length(tPhys->lCurrentlyCollides) > 0;
+    return tPhys->tWorld != NULL && tPhys->tWorld->uContacts[tPhys->uBody] > 0;
+}
+
+/* 
+ *  @brief - registers a handler receiving enter, stay and exit events of the body.
+ *
+ *  @tPhys      - physics controller of the body.
+ *  @fHnd       - handler to invoke after each step. NULL removes the handler.
+ *  @vUserData  - pointer passed to the handler.
+ * */
+void vPhysicsOnCollision(tPhysController *tPhys, fCollisionHandler fHnd, void *vUserData) {
+    if (tPhys->tWorld == NULL)
+        return;
+
+    tPhys->tWorld->fHandlers[tPhys->uBody] = fHnd;
+    tPhys->tWorld->vHandlersData[tPhys->uBody] = vUserData;
+}
+
+/* 
+ *  @brief - gives the collision events produced by the last step of the world.
+ *
+ *  @tWorld     - physics world, i.e the one of the controller.
+ *  @tEvents    - receives the event queue. Valid until the next step.
+ *
+ *  Returns the amount of events.
+ * */
+uint32_t uPhysicsCollisionEvents(tPhysicsWorld *tWorld, const tCollisionEvent **tEvents) {
+    if (tWorld == NULL) {
+        *tEvents = NULL;
+        return 0;
+    }
+
+    *tEvents = tWorld->tEvents;
+    return tWorld->uEvents;
 }
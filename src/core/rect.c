@@ -25,24 +25,56 @@
 
 
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 #include <tllist.h>
 
 #include <context2d.h>
 #include <runtime.h>
 #include <rect.h>
+#include <texture.h>
+#include <glyph.h>
+#include <physics.h>
 #include <intrinsics.h>
 #include <log.h>
+#include <trace.h>
+
+/* Arguments of the texture calls, which run on the render thread. */
+typedef struct {
+    tRuntime *tRun;
+    const char *sPath;
+    SDL_Surface *sdlSurf;
+    SDL_Texture *sdlTexture;
+    tTexture *tTex;
+} __tRectTextureCall;
+
+static void __vRectCreateTexture(void *vArg) {
+    __tRectTextureCall *tCall = vArg;
+    tCall->sdlTexture = SDL_CreateTextureFromSurface(tCall->tRun->sdlRenderer, tCall->sdlSurf);
+}
+
+static void __vRectAcquireTexture(void *vArg) {
+    __tRectTextureCall *tCall = vArg;
+    tCall->tTex = tTextureCacheAcquire(&tCall->tRun->tTextures, tCall->tRun->sdlRenderer, tCall->sPath);
+}
+
+static void __vRectWhiteTexture(void *vArg) {
+    __tRectTextureCall *tCall = vArg;
+    tCall->sdlTexture = sdlTextureCacheWhite(&tCall->tRun->tTextures, tCall->tRun->sdlRenderer);
+}
 
 int __vRectFromTextureRaw(tRuntime *tRun, tRect *tRct, SDL_Surface *sdlSurf) {
     if (tRct == NULL) {
         vFeatherLogError("Internal error. NULL Rect in __vRectFromTextureRaw function.");
     }
 
-    tRct->tFr.uWidth = sdlSurf->w; 
-    tRct->tFr.uHeight = sdlSurf->h;
+    tRct->tFr.uWidth = tRct->uTexWidth = sdlSurf->w; 
+    tRct->tFr.uHeight = tRct->uTexHeight = sdlSurf->h;
 
     // Generate SDL_Texture from surface
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(tRun->sdlRenderer, sdlSurf);
+    __tRectTextureCall tCall = { .tRun = tRun, .sdlSurf = sdlSurf };
+    vRenderThreadCall(tRun->tRender, __vRectCreateTexture, &tCall);
+    SDL_Texture* texture = tCall.sdlTexture;
     if (!texture) {
         vFeatherLogError("Unable to create texture from surface: %s", SDL_GetError());
         SDL_FreeSurface(sdlSurf);
@@ -52,6 +84,7 @@ int __vRectFromTextureRaw(tRuntime *tRun, tRect *tRct, SDL_Surface *sdlSurf) {
 
     // Store the texture in the rectangle
     tRct->idTextureID = (uintptr_t)texture;
+    __vRectRefreshFrame(tRct);
     return 0;
 }
 
@@ -61,44 +94,69 @@ tRect* tInitRect(tRuntime *tRun, tContext2D tCtx, uint16_t uPriority, char* sTex
         .tAnims = tll_init(), 
         .tCtx = tCtx, 
         .sTexturePath = sTexturePath, 
+        .sdlColor = __FEATHER__WHITE__,
         .uPriority = uPriority, 
         .tFr.uIdx = 0,
-        .uRectId = uRectIDIncrementer++,
     };
+    FEATHER_TRACE_BEGIN(uStart);
 
     if (sTexturePath == NULL) {
         // Color can be adjusted later.
         vChangeRectColor(tRun, &tRct, (SDL_Color) { 255, 255, 255, 255 });
     } else {
-        // Load texture using SDL_image
-        SDL_Surface* sdlSurf;
-        sdlSurf = IMG_Load(sTexturePath);
-
-        if (!sdlSurf) {
-            vFeatherLogError("Unable to load rect texture: %s", IMG_GetError());
+        // Texture is shared with all other rects using the same path.
+        __tRectTextureCall tCall = { .tRun = tRun, .sPath = sTexturePath };
+        vRenderThreadCall(tRun->tRender, __vRectAcquireTexture, &tCall);
+        tTexture *tTex = tCall.tTex;
+        if (tTex == NULL)
             return NULL;
-        }
 
-        if (__vRectFromTextureRaw(tRun, &tRct, sdlSurf) < 0)
-            return NULL;
-        vFeatherLogInfo("Loading asset: Rect texture: %s...", strrchr(sTexturePath, '/') + 1);
+        tRct.idTextureID = (uintptr_t)tTex->sdlTexture;
+        tRct.sTexturePath = tTex->sPath;
+        tRct.tFr.uWidth = tRct.uTexWidth = tTex->uWidth;
+        tRct.tFr.uHeight = tRct.uTexHeight = tTex->uHeight;
+        __vRectRefreshFrame(&tRct);
     }
 
-    // Insert the rectangle into the list with priority handling
-    tll_foreach(tRun->sScene->lRects, it)
-        if (it->item.uPriority > uPriority) {
-            tll_insert_before(tRun->sScene->lRects, it, tRct);
-            return (tRect*)it->prev;
-        }
-
-    // New higher priority rectangles are pushed to the front
-    tll_push_back(tRun->sScene->lRects, tRct);
-    return (tRect*)tRun->sScene->lRects.tail;
+    tRect *tStored = tRectPoolInsert(&tRun->sScene->tRects, tRct);
+    FEATHER_TRACE_END(uStart, "asset", "tInitRect %s", sTexturePath ? sTexturePath : "(color)");
+    return tStored;
 }
 
 #include <SDL.h>
 #include <stdint.h>
 
+/* 
+ *  @brief - drops the texture currently held by the rect.
+ *
+ *  Cached textures are only destroyed once no other rect uses them, while textures owned by the
+ *  rect itself are destroyed right away. Text rects drop their glyph run instead.
+ * */
+static void __vRectReleaseTexture(tRuntime *tRun, tRect *tRct) {
+    SDL_Texture* oldTexture = (SDL_Texture*)tRct->idTextureID;
+
+    // Atlas pages are shared by all texts of the font, so only the atlas reference is dropped.
+    if (tRct->tGlyphs != NULL) {
+        vGlyphAtlasRelease(&tRun->tGlyphs, tRct->tGlyphs->tAtlas);
+        vGlyphRunFree(tRct->tGlyphs);
+        tRct->tGlyphs = NULL;
+        oldTexture = NULL;
+    }
+
+    if (oldTexture == NULL) {
+        tRct->idTextureID = 0;
+        tRct->sTexturePath = NULL;
+        return;
+    }
+
+    // The white texture of solid color rects is shared and never released.
+    if (oldTexture != tRun->tTextures.sdlWhite && !bTextureCacheRelease(&tRun->tTextures, tRct->sTexturePath))
+        vRenderThreadDestroyTexture(tRun->tRender, oldTexture);
+
+    tRct->idTextureID = 0;
+    tRct->sTexturePath = NULL;
+}
+
 /* 
  *  @brief - Change the color of the rectangle.
  *
@@ -106,39 +164,48 @@ tRect* tInitRect(tRuntime *tRun, tContext2D tCtx, uint16_t uPriority, char* sTex
  *  @tRct          - Pointer to the rectangle.
  *  @fallbackColor - New fallback color to apply.
  *
- *  This also destroys the currently applied texture. Here context2D's scaleX and scaleY decides the size of the colored block.
+ *  This also releases the currently applied texture. Here context2D's scaleX and scaleY decides the size of the colored block.
+ *  Solid colors tint one shared white texture, so changing the color is a plain store.
  */
 void vChangeRectColor(tRuntime* tRun, tRect* tRct, SDL_Color fallbackColor) {
-    SDL_Texture* oldTexture = (SDL_Texture*)tRct->idTextureID;
-    if (oldTexture) {
-        SDL_DestroyTexture(oldTexture);
-        tRct->idTextureID = 0;
-    }
+    SDL_Texture *sdlWhite = tRun->tTextures.sdlWhite;
 
-    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, 
-            1 * (int)tRct->tCtx.fScaleX, 
-            1 * (int)tRct->tCtx.fScaleY, 
-            32, SDL_PIXELFORMAT_RGBA32
-    );
+    // The white texture is only uploaded once, so later color changes don't wait for the render thread.
+    if (sdlWhite == NULL) {
+        __tRectTextureCall tCall = { .tRun = tRun };
+        vRenderThreadCall(tRun->tRender, __vRectWhiteTexture, &tCall);
+        sdlWhite = tCall.sdlTexture;
+    }
+    tRct->sdlColor = fallbackColor;
 
-    if (!surface) {
-        vFeatherLogError("Unable to create surface for new color: %s", SDL_GetError());
+    // Already in color mode, only the tint changes.
+    if ((SDL_Texture*)tRct->idTextureID == sdlWhite)
         return;
-    }
 
-    Uint32 color = SDL_MapRGBA(surface->format, fallbackColor.r, fallbackColor.g, fallbackColor.b, fallbackColor.a);
-    SDL_FillRect(surface, NULL, color);
-    SDL_Texture* newTexture = SDL_CreateTextureFromSurface(tRun->sdlRenderer, surface);
-    SDL_FreeSurface(surface);
+    __vRectReleaseTexture(tRun, tRct);
+    tRct->idTextureID = (uintptr_t)sdlWhite;
+    tRct->tFr.uIdx = 0;
+    tRct->tFr.uWidth = tRct->uTexWidth = 1;
+    tRct->tFr.uHeight = tRct->uTexHeight = 1;
+    __vRectRefreshFrame(tRct);
+}
 
-    if (!newTexture) {
-        vFeatherLogError("Unable to create new texture for rectangle: %s", SDL_GetError());
-        return;
-    }
+/* 
+ *  @brief - recomputes the cached source rect from the texture size and the current frame.
+ *
+ *  Must be called whenever the texture or the frame of the rect changes.
+ * */
+void __vRectRefreshFrame(tRect *tRct) {
+    tRct->uColumns = tRct->tFr.uWidth ? tRct->uTexWidth / tRct->tFr.uWidth : 0;
 
-    tRct->idTextureID = (uintptr_t)newTexture;
-    tRct->tFr.uWidth = 1 * (int)tRct->tCtx.fScaleX;
-    tRct->tFr.uHeight = 1 * (int)tRct->tCtx.fScaleY;
+    // Frames wider than the texture still map onto the first column.
+    if (tRct->uColumns == 0)
+        tRct->uColumns = 1;
+
+    tRct->sdlSrc.x = (tRct->tFr.uIdx % tRct->uColumns) * tRct->tFr.uWidth;
+    tRct->sdlSrc.y = (tRct->tFr.uIdx / tRct->uColumns) * tRct->tFr.uHeight;
+    tRct->sdlSrc.w = tRct->tFr.uWidth;
+    tRct->sdlSrc.h = tRct->tFr.uHeight;
 }
 
 /* 
@@ -146,6 +213,7 @@ void vChangeRectColor(tRuntime* tRun, tRect* tRct, SDL_Color fallbackColor) {
  * */
 void vRectFrame(tRect *tRct, uint8_t uIdx) {
     tRct->tFr.uIdx = uIdx;
+    __vRectRefreshFrame(tRct);
 }
 
 /* 
@@ -155,6 +223,7 @@ void vRectIndexate(tRect *tRct, uint8_t uIdx, uint32_t uWidth, uint32_t uHeight)
     tRct->tFr.uIdx = uIdx;
     tRct->tFr.uHeight = uHeight;
     tRct->tFr.uWidth = uWidth;
+    __vRectRefreshFrame(tRct);
 }
 
 /* 
@@ -179,7 +248,7 @@ void vAnimateFrame(tRuntime *tRun, tRect *tRct, uint16_t uAnimationId, float fSp
 
                 tll_foreach(tAnim->item.uFrames, tFrame) {
                     if (uFIdx == tAnim->item.uCurrent)
-                        tRct->tFr.uIdx = tFrame->item;
+                        vRectFrame(tRct, tFrame->item);
                     ++uFIdx;
                 }
             }
@@ -213,62 +282,70 @@ uint16_t vRectAppendAnimation(tRect *tRct, uint8_t *uIdx, uint8_t uIdxLength) {
  *  @tRun            - currently running runtime.
  *  @tRct            - pointer to the rectange we wish to change
  *  @sNewTexturePath - path to the new texture source.
+ *
+ *  The frame is reset to the whole new texture, sprite sheets shall be indexated again.
  * */
 void vChangeRectTexture(tRuntime* tRun, tRect* tRct, char* sNewTexturePath) {
-    // Unload the existing texture
-    SDL_Texture* oldTexture = (SDL_Texture*)tRct->idTextureID;
-    if (oldTexture) {
-        SDL_DestroyTexture(oldTexture);
-        tRct->idTextureID = 0; // Reset the texture ID
-    }
-    SDL_Surface* surface = IMG_Load(sNewTexturePath);
-    if (!surface) {
-        vFeatherLogError("Unable to load new texture: %s", IMG_GetError());
+    // Acquiring before releasing, so swapping to the same texture never reloads it.
+    __tRectTextureCall tCall = { .tRun = tRun, .sPath = sNewTexturePath };
+    vRenderThreadCall(tRun->tRender, __vRectAcquireTexture, &tCall);
+    tTexture *tTex = tCall.tTex;
+    if (tTex == NULL) {
+        vFeatherLogError("Unable to load new texture: %s", sNewTexturePath);
         return;
     }
 
-    SDL_Texture* newTexture = SDL_CreateTextureFromSurface(tRun->sdlRenderer, surface);
-    SDL_FreeSurface(surface);
+    SDL_Texture *newTexture = tTex->sdlTexture;
+    char *sPath = tTex->sPath;
+    uint32_t uWidth = tTex->uWidth, uHeight = tTex->uHeight;
 
-    if (!newTexture) {
-        vFeatherLogError("Unable to create new texture from surface: %s", SDL_GetError());
-        return;
-    }
+    // Leaving the color mode, so the previous color shall not tint the texture.
+    if ((SDL_Texture*)tRct->idTextureID == tRun->tTextures.sdlWhite)
+        tRct->sdlColor = __FEATHER__WHITE__;
 
+    __vRectReleaseTexture(tRun, tRct);
     tRct->idTextureID = (uintptr_t)newTexture;
-    tRct->sTexturePath = strdup(sNewTexturePath);
+    tRct->sTexturePath = sPath;
+    tRct->tFr.uIdx = 0;
+    tRct->tFr.uWidth = tRct->uTexWidth = uWidth;
+    tRct->tFr.uHeight = tRct->uTexHeight = uHeight;
+    __vRectRefreshFrame(tRct);
 } __attribute__((nonnull(1, 2)))
 
 // Draw the rectangle using SDL renderer
 void vDrawRect(tRuntime *tRun, tRect *rect) {
-    SDL_Rect srcRect, dstRect;
+    SDL_Rect dstRect;
     SDL_Point sdlCenter;
     SDL_Renderer* sdlRend = tRun->sdlRenderer;
     SDL_Texture* texture = (SDL_Texture*)rect->idTextureID;
+    const SDL_Rect *srcRect = &rect->sdlSrc;
 
-    int uWidth, uHeight, uColumns;
-    SDL_QueryTexture(texture, NULL, NULL, &uWidth, &uHeight);
-
-    // indexing for framing. 
-    uColumns = uWidth / rect->tFr.uWidth;
-    srcRect.x = (rect->tFr.uIdx % uColumns) * rect->tFr.uWidth;
-    srcRect.y = (rect->tFr.uIdx / uColumns) * rect->tFr.uHeight;
-    srcRect.w = rect->tFr.uWidth;
-    srcRect.h = rect->tFr.uHeight;
+    if (rect->tGlyphs != NULL) {
+        for (uint32_t i = 0; i < rect->tGlyphs->uCount; ++i) {
+            tRenderCmd tCmd = tGlyphRunCmd(rect, i);
+            vDrawRenderCmd(sdlRend, &tCmd);
+        }
+        return;
+    }
 
     dstRect.x = (int)rect->tCtx.fX;
     dstRect.y = (int)rect->tCtx.fY;
-    dstRect.w = (int)(srcRect.w * rect->tCtx.fScaleX);
-    dstRect.h = (int)(srcRect.h * rect->tCtx.fScaleY);
+    dstRect.w = (int)(srcRect->w * rect->tCtx.fScaleX);
+    dstRect.h = (int)(srcRect->h * rect->tCtx.fScaleY);
 
-    sdlCenter.x = dstRect.x + dstRect.w / 2;
-    sdlCenter.y = dstRect.y + dstRect.h / 2;
+    // SDL expects the rotation center relative to the destination rect.
+    sdlCenter.x = dstRect.w / 2;
+    sdlCenter.y = dstRect.h / 2;
+
+    // Textures are shared between rects, so the tint is applied on each draw.
+    SDL_SetTextureColorMod(texture, rect->sdlColor.r, rect->sdlColor.g, rect->sdlColor.b);
+    SDL_SetTextureAlphaMod(texture, rect->sdlColor.a);
 
     // Render the texture with the calculated position, scale, and rotation
     SDL_RenderCopyEx(
         sdlRend,
         texture,
-        &srcRect, 
+        srcRect, 
         &dstRect,     
         rect->tCtx.fRotation,
         &sdlCenter,
@@ -277,9 +354,9 @@ void vDrawRect(tRuntime *tRun, tRect *rect) {
 }
 
 void __vFullscreenInner(tRect *tRct, tRuntime *tRun, bool w, bool h) {
-    int ww, wh, wr, hr;
+    int ww, wh;
+    int wr = tRct->uTexWidth, hr = tRct->uTexHeight;
     vRuntimeGetWindowDimensions(tRun, &ww, &wh);
-    SDL_QueryTexture((SDL_Texture*)tRct->idTextureID, NULL, NULL, &wr, &hr);
     tRct->tCtx.fScaleX = w ? (float)ww / (float)wr : (float)wh / (float)hr;
     tRct->tCtx.fScaleY = h ? (float)wh / (float)hr : (float)ww / (float)wr;
 }
@@ -318,13 +395,239 @@ void vFullScreenRectHeight(tRect *tRct, tRuntime *tRun) {
 /* 
  *  Provides a proper pointer to the rect, based on it's ID.
  *
- *  This must be used to prevent pointer problems, when more rects are added.
+ *  Lookup is O(1). Returns NULL if the rect was destroyed, even if it's slot was reused since.
  * */
 tRect *tGetRect(tRuntime *tRun, uint32_t uRectId) {
-    tRect *tRctPtr = NULL;
-    tll_foreach(tRun->sScene->lRects, tRct)
-        if (tRct->item.uRectId == uRectId)
-            tRctPtr = &tRct->item;
+    return tRectPoolGet(&tRun->sScene->tRects, uRectId);
+}
+
+/* 
+ *  @brief - removes the rect from the current scene.
+ *
+ *  @tRun - currently running runtime.
+ *  @tRct - pointer to the rect to remove. It is invalid after this call.
+ *
+ *  The texture is released, so it is destroyed if no other rect is using it anymore.
+ *  The rect's physical body is removed from the scene's physics world as well.
+ * */
+void vDestroyRect(tRuntime *tRun, tRect *tRct) {
+    if (tRectPoolGet(&tRun->sScene->tRects, tRct->uRectId) != tRct) {
+        vFeatherLogWarn("Unable to destroy rect: %d. Rect is not within the current scene.", tRct->uRectId);
+        return;
+    }
+
+    // The physics world shall not move the slot, once it is reused by another rect.
+    vPhysicsRemove(tRun->sScene->tPhysics, tRct);
+    __vRectReleaseTexture(tRun, tRct);
+    tll_foreach(tRct->tAnims, tAnim)
+        tll_free(tAnim->item.uFrames);
+    tll_free(tRct->tAnims);
+    bRectPoolRemove(&tRun->sScene->tRects, tRct);
+}
+
+static int __iRectPoolGrow(tRectPool *tPool) {
+    uint32_t uNewCapacity = tPool->uCapacity ? tPool->uCapacity * 2 : __FEATHER_RECT_PAGE_SIZE;
+
+    uint32_t *uOrder = realloc(tPool->uOrder, uNewCapacity * sizeof(uint32_t));
+    if (uOrder == NULL)
+        return -1;
+    tPool->uOrder = uOrder;
+
+    uint32_t *uFree = realloc(tPool->uFree, uNewCapacity * sizeof(uint32_t));
+    if (uFree == NULL)
+        return -1;
+    tPool->uFree = uFree;
+
+    uint64_t *uSortKeys = realloc(tPool->uSortKeys, uNewCapacity * 2 * sizeof(uint64_t));
+    if (uSortKeys == NULL)
+        return -1;
+    tPool->uSortKeys = uSortKeys;
+
+    tPool->uCapacity = uNewCapacity;
+    return 0;
+}
+
+static int __iRectPoolAddPage(tRectPool *tPool) {
+    tRect **tPages = realloc(tPool->tPages, (tPool->uPages + 1) * sizeof(tRect*));
+    if (tPages == NULL)
+        return -1;
+    tPool->tPages = tPages;
+
+    uint16_t *uGenerations = realloc(tPool->uGenerations, (tPool->uPages + 1) * __FEATHER_RECT_PAGE_SIZE * sizeof(uint16_t));
+    if (uGenerations == NULL)
+        return -1;
+    tPool->uGenerations = uGenerations;
+
+    tPool->tPages[tPool->uPages] = calloc(__FEATHER_RECT_PAGE_SIZE, sizeof(tRect));
+    if (tPool->tPages[tPool->uPages] == NULL)
+        return -1;
+
+    memset(&tPool->uGenerations[tPool->uPages * __FEATHER_RECT_PAGE_SIZE], 0, __FEATHER_RECT_PAGE_SIZE * sizeof(uint16_t));
+    tPool->uPages++;
+    return 0;
+}
+
+/* 
+ *  @brief - moves the rect into the pool and assigns it a new handle.
+ *
+ *  Returns a pointer to the stored rect, which stays valid until the rect is removed.
+ * */
+tRect* tRectPoolInsert(tRectPool *tPool, tRect tRct) {
+    uint32_t uSlot;
+    tRect *tStored;
+
+    if (tPool->uCount == tPool->uCapacity && __iRectPoolGrow(tPool) < 0) {
+        vFeatherLogError("Unable to grow the rect pool.");
+        return NULL;
+    }
+
+    if (tPool->uFreeCount) {
+        uSlot = tPool->uFree[--tPool->uFreeCount];
+    } else {
+        if (tPool->uSlots > __FEATHER_RECT_SLOT_MASK) {
+            vFeatherLogError("Rect pool is full.");
+            return NULL;
+        }
+
+        if (tPool->uSlots == tPool->uPages * __FEATHER_RECT_PAGE_SIZE && __iRectPoolAddPage(tPool) < 0) {
+            vFeatherLogError("Unable to allocate a new rect page.");
+            return NULL;
+        }
+        uSlot = tPool->uSlots++;
+    }
+
+    // Sequences ran out of key bits, live rects are renumbered in their current order.
+    if (tPool->uNextSeq == 1u << __FEATHER_RECT_SEQ_BITS) {
+        vRectPoolSort(tPool);
+        for (tPool->uNextSeq = 0; tPool->uNextSeq < tPool->uCount; ++tPool->uNextSeq)
+            tRectPoolAt(tPool, tPool->uNextSeq)->uSeq = tPool->uNextSeq;
+    }
+
+    tStored = __tRectPoolSlot(tPool, uSlot);
+    *tStored = tRct;
+    tStored->uRectId = __FEATHER_RECT_HANDLE(uSlot, tPool->uGenerations[uSlot]);
+    tStored->uSeq = tPool->uNextSeq++;
+
+    // Appended as is, the order is restored by the sort before the next render.
+    tPool->uOrder[tPool->uCount++] = uSlot;
+
+    return tStored;
+}
+
+/* 
+ *  @brief - resolves the handle to the rect in O(1). Returns NULL for stale or unknown handles.
+ * */
+tRect* tRectPoolGet(tRectPool *tPool, uint32_t uRectId) {
+    uint32_t uSlot = uRectId & __FEATHER_RECT_SLOT_MASK;
+    tRect *tRct;
+
+    if (uRectId == FEATHER_RECT_INVALID || uSlot >= tPool->uSlots)
+        return NULL;
+
+    tRct = __tRectPoolSlot(tPool, uSlot);
+    return tRct->uRectId == uRectId ? tRct : NULL;
+}
+
+/* 
+ *  @brief - removes the rect from the pool. Returns false if the rect is not within the pool.
+ *
+ *  The rect's slot is reused by later insertions, with a new generation.
+ * */
+bool bRectPoolRemove(tRectPool *tPool, tRect *tRct) {
+    uint32_t uSlot = tRct->uRectId & __FEATHER_RECT_SLOT_MASK;
+
+    if (tRectPoolGet(tPool, tRct->uRectId) != tRct)
+        return false;
+
+    // Swapping with the last one, the order is restored by the sort before the next render.
+    for (uint32_t i = 0; i < tPool->uCount; ++i)
+        if (tPool->uOrder[i] == uSlot) {
+            tPool->uOrder[i] = tPool->uOrder[tPool->uCount - 1];
+            break;
+        }
+
+    // Generations wrap around before the handle could collide with the invalid one.
+    if (++tPool->uGenerations[uSlot] >= (1u << (32 - __FEATHER_RECT_SLOT_BITS)) - 1)
+        tPool->uGenerations[uSlot] = 0;
+    tRct->uRectId = FEATHER_RECT_INVALID;
+    tPool->uFree[tPool->uFreeCount++] = uSlot;
+    tPool->uCount--;
+    return true;
+}
+
+/* Sorting key: priority in the upper 16 bits, creation sequence below it and the slot in the lowest bits. */
+static inline uint64_t __uRectSortKey(tRect *tRct, uint32_t uSlot) {
+    return ((uint64_t)tRct->uPriority << 48) | ((uint64_t)tRct->uSeq << __FEATHER_RECT_SLOT_BITS) | uSlot;
+}
+
+/* 
+ *  @brief - sorts the rendering order by priority, and by creation within the same priority.
+ *
+ *  Called once per frame before rendering. Runs in linear time and does nothing if the order is
+ *  already sorted.
+ * */
+void vRectPoolSort(tRectPool *tPool) {
+    uint64_t *uSrc = tPool->uSortKeys, *uDst = tPool->uSortKeys + tPool->uCapacity, *uTmp;
+    uint32_t uCounts[256];
+    bool bSorted = true;
+
+    // The slot is a part of the key, so it travels with it.
+    for (uint32_t i = 0; i < tPool->uCount; ++i) {
+        uSrc[i] = __uRectSortKey(tRectPoolAt(tPool, i), tPool->uOrder[i]);
+        if (i && uSrc[i] < uSrc[i - 1])
+            bSorted = false;
+    }
+
+    if (bSorted)
+        return;
+
+    // LSD radix sort over the bytes above the slot. Sequences are unique, so no two keys are equal.
+    for (uint32_t uShift = __FEATHER_RECT_SLOT_BITS; uShift < 64; uShift += 8) {
+        memset(uCounts, 0, sizeof(uCounts));
+        for (uint32_t i = 0; i < tPool->uCount; ++i)
+            uCounts[(uSrc[i] >> uShift) & 0xFF]++;
+
+        // All keys share this byte, nothing to reorder.
+        if (uCounts[(uSrc[0] >> uShift) & 0xFF] == tPool->uCount)
+            continue;
+
+        for (uint32_t i = 0, uSum = 0; i < 256; ++i) {
+            uint32_t uCount = uCounts[i];
+            uCounts[i] = uSum;
+            uSum += uCount;
+        }
+
+        for (uint32_t i = 0; i < tPool->uCount; ++i)
+            uDst[uCounts[(uSrc[i] >> uShift) & 0xFF]++] = uSrc[i];
+
+        uTmp = uSrc;
+        uSrc = uDst;
+        uDst = uTmp;
+    }
+
+    for (uint32_t i = 0; i < tPool->uCount; ++i)
+        tPool->uOrder[i] = (uint32_t)uSrc[i] & __FEATHER_RECT_SLOT_MASK;
+}
+
+/* 
+ *  @brief - frees all pool storage together with the animations of live rects.
+ * */
+void vRectPoolFree(tRectPool *tPool) {
+    for (uint32_t i = 0; i < tPool->uCount; ++i) {
+        tRect *tRct = tRectPoolAt(tPool, i);
+        tll_foreach(tRct->tAnims, tAnim)
+            tll_free(tAnim->item.uFrames);
+        tll_free(tRct->tAnims);
+        vGlyphRunFree(tRct->tGlyphs);
+    }
+
+    for (uint32_t i = 0; i < tPool->uPages; ++i)
+        free(tPool->tPages[i]);
 
-    return tRctPtr;
+    free(tPool->tPages);
+    free(tPool->uGenerations);
+    free(tPool->uFree);
+    free(tPool->uOrder);
+    free(tPool->uSortKeys);
+    *tPool = (tRectPool) {0};
 }
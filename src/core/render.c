@@ -0,0 +1,301 @@
+/**************************************************************************************************
+ *  File: render.c
+ *  Desc: Render thread. The update phase records the rects of each frame into a command list, which a
+ *  dedicated thread submits to the renderer while the next frame is computed.
+ **************************************************************************************************
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ * */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <render.h>
+#include <glyph.h>
+#include <intrinsics.h>
+#include <log.h>
+
+#define __RENDER_LIST_INITIAL_CAPACITY 256
+
+/* Draws and presents the list, then destroys the textures released while it was recorded. */
+static void __vRenderSubmitList(tRenderThread *tRender, tRenderList *tList) {
+    SDL_RenderClear(tRender->sdlRenderer);
+
+#if FEATHER_RENDER_BATCHING
+    tRender->tBatch.uDrawCalls = 0;
+    for (uint32_t i = 0; i < tList->uCount; ++i)
+        vBatchPushCmd(&tRender->tBatch, tRender->sdlRenderer, &tList->tCmds[i]);
+    vBatchFlush(&tRender->tBatch, tRender->sdlRenderer);
+#else
+    for (uint32_t i = 0; i < tList->uCount; ++i)
+        vDrawRenderCmd(tRender->sdlRenderer, &tList->tCmds[i]);
+#endif
+
+    SDL_RenderPresent(tRender->sdlRenderer);
+
+    // Frames recorded later never reference these, and the previous one is already presented.
+    for (uint32_t i = 0; i < tList->uGraveCount; ++i)
+        SDL_DestroyTexture(tList->sdlGraveyard[i]);
+
+    tList->uCount = 0;
+    tList->uGraveCount = 0;
+}
+
+static int __iRenderThread(void *vArg) {
+    tRenderThread *tRender = vArg;
+
+    SDL_LockMutex(tRender->sdlLock);
+    for (;;) {
+        while (!tRender->bPending && tRender->fCall == NULL && tRender->bRunning)
+            SDL_CondWait(tRender->sdlQueued, tRender->sdlLock);
+
+        if (tRender->bPending) {
+            // The list not being recorded is owned by this thread until the pending flag is cleared.
+            tRenderList *tList = &tRender->tLists[tRender->uRecord ^ 1];
+            SDL_UnlockMutex(tRender->sdlLock);
+
+            __vRenderSubmitList(tRender, tList);
+
+            SDL_LockMutex(tRender->sdlLock);
+            tRender->bPending = false;
+            SDL_CondSignal(tRender->sdlSubmitted);
+        } else if (tRender->fCall != NULL) {
+            // Calls wait for the pending frame, so they never destroy anything it draws.
+            fClosure fCall = tRender->fCall;
+            void *vCallArg = tRender->vCallArg;
+            SDL_UnlockMutex(tRender->sdlLock);
+
+            fCall(vCallArg);
+
+            SDL_LockMutex(tRender->sdlLock);
+            tRender->fCall = NULL;
+            tRender->uCallsDone++;
+            SDL_CondBroadcast(tRender->sdlCalled);
+        } else {
+            break;
+        }
+    }
+    SDL_UnlockMutex(tRender->sdlLock);
+
+    // Nothing is drawn anymore, so the textures released since the last submission can go as well.
+    for (uint32_t i = 0; i < 2; ++i) {
+        for (uint32_t j = 0; j < tRender->tLists[i].uGraveCount; ++j)
+            SDL_DestroyTexture(tRender->tLists[i].sdlGraveyard[j]);
+        tRender->tLists[i].uGraveCount = 0;
+    }
+
+    return 0;
+}
+
+/* Arguments of the renderer creation, which runs on the render thread. */
+typedef struct {
+    tRenderThread *tRender;
+    SDL_Window *sdlWindow;
+    uint32_t uFlags;
+} __tRenderCreateArgs;
+
+static void __vRenderCreate(void *vArg) {
+    __tRenderCreateArgs *tArgs = vArg;
+    tArgs->tRender->sdlRenderer = SDL_CreateRenderer(tArgs->sdlWindow, -1, tArgs->uFlags);
+}
+
+static void __vRenderListFree(tRenderList *tList) {
+    free(tList->tCmds);
+    free(tList->sdlGraveyard);
+    *tList = (tRenderList) {0};
+}
+
+/* 
+ *  @brief - starts the render thread and creates the window's renderer on it.
+ *
+ *  @sdlWindow  - window the renderer draws to.
+ *  @uFlags     - SDL_RendererFlags passed to SDL_CreateRenderer.
+ *
+ *  Returns NULL if the thread or the renderer can't be created, in which case frames shall be rendered directly.
+ * */
+tRenderThread* tRenderThreadCreate(SDL_Window *sdlWindow, uint32_t uFlags) {
+    tRenderThread *tRender = calloc(1, sizeof(tRenderThread));
+    if (tRender == NULL)
+        return NULL;
+
+    tRender->bRunning = true;
+    tRender->sdlLock = SDL_CreateMutex();
+    tRender->sdlSubmitted = SDL_CreateCond();
+    tRender->sdlQueued = SDL_CreateCond();
+    tRender->sdlCalled = SDL_CreateCond();
+
+    if (tRender->sdlLock != NULL && tRender->sdlSubmitted != NULL && tRender->sdlQueued != NULL && tRender->sdlCalled != NULL)
+        tRender->sdlThread = SDL_CreateThread(__iRenderThread, "feather_render", tRender);
+
+    if (tRender->sdlThread == NULL) {
+        vFeatherLogWarn("Unable to start the render thread: %s", SDL_GetError());
+        vRenderThreadFree(tRender);
+        return NULL;
+    }
+
+    // Contexts of some backends are bound to the thread that created them, so the renderer is created there.
+    __tRenderCreateArgs tArgs = { .tRender = tRender, .sdlWindow = sdlWindow, .uFlags = uFlags };
+    vRenderThreadCall(tRender, __vRenderCreate, &tArgs);
+    if (tRender->sdlRenderer == NULL) {
+        vFeatherLogWarn("Unable to create the renderer on the render thread: %s", SDL_GetError());
+        vRenderThreadFree(tRender);
+        return NULL;
+    }
+
+    vFeatherLogInfo("Render thread started.");
+    return tRender;
+}
+
+/* Appends the command to the recorded list, growing it when full. */
+static void __vRenderListPush(tRenderList *tList, tRenderCmd tCmd) {
+    if (tList->uCount == tList->uCapacity) {
+        uint32_t uNewCapacity = tList->uCapacity ? tList->uCapacity * 2 : __RENDER_LIST_INITIAL_CAPACITY;
+        tRenderCmd *tCmds = realloc(tList->tCmds, uNewCapacity * sizeof(tRenderCmd));
+        if (tCmds == NULL) {
+            vFeatherLogError("Unable to grow the render list.");
+            return;
+        }
+        tList->tCmds = tCmds;
+        tList->uCapacity = uNewCapacity;
+    }
+
+    tList->tCmds[tList->uCount++] = tCmd;
+}
+
+/* 
+ *  @brief - records the current state of the rect into the frame.
+ * */
+void vRenderThreadPushRect(tRenderThread *tRender, tRect *tRct) {
+    tRenderList *tList = &tRender->tLists[tRender->uRecord];
+
+    // Glyph quads are copied as well, so texts can be edited while the frame is drawn.
+    if (tRct->tGlyphs != NULL) {
+        for (uint32_t i = 0; i < tRct->tGlyphs->uCount; ++i)
+            if (tRct->tGlyphs->tQuads[i].sdlPage != NULL)
+                __vRenderListPush(tList, tGlyphRunCmd(tRct, i));
+        return;
+    }
+
+    __vRenderListPush(tList, tBatchCmdFromRect(tRct));
+}
+
+/* 
+ *  @brief - hands the recorded frame over to the render thread.
+ *
+ *  Waits until the previous frame is presented, so the update phase is at most one frame ahead.
+ * */
+void vRenderThreadSubmit(tRenderThread *tRender) {
+    SDL_LockMutex(tRender->sdlLock);
+    while (tRender->bPending)
+        SDL_CondWait(tRender->sdlSubmitted, tRender->sdlLock);
+
+    tRender->uRecord ^= 1;
+    tRender->bPending = true;
+    SDL_CondSignal(tRender->sdlQueued);
+    SDL_UnlockMutex(tRender->sdlLock);
+}
+
+/* 
+ *  @brief - destroys the texture once no submitted frame can reference it anymore.
+ *
+ *  Without a render thread the texture is destroyed right away.
+ * */
+void vRenderThreadDestroyTexture(tRenderThread *tRender, SDL_Texture *sdlTexture) {
+    if (tRender == NULL) {
+        SDL_DestroyTexture(sdlTexture);
+        return;
+    }
+
+    tRenderList *tList = &tRender->tLists[tRender->uRecord];
+    if (tList->uGraveCount == tList->uGraveCapacity) {
+        uint32_t uNewCapacity = tList->uGraveCapacity ? tList->uGraveCapacity * 2 : 16;
+        SDL_Texture **sdlGraveyard = realloc(tList->sdlGraveyard, uNewCapacity * sizeof(SDL_Texture*));
+        if (sdlGraveyard == NULL) {
+            // Leaking the texture is safer than destroying one, which may still be drawn.
+            vFeatherLogError("Unable to defer the texture destruction.");
+            return;
+        }
+        tList->sdlGraveyard = sdlGraveyard;
+        tList->uGraveCapacity = uNewCapacity;
+    }
+
+    tList->sdlGraveyard[tList->uGraveCount++] = sdlTexture;
+}
+
+/* 
+ *  @brief - runs the closure on the render thread and waits for it to return.
+ *
+ *  Every call using the renderer, like texture uploads, shall be made through this function. Calls wait for
+ *  the frame in submission to be presented. Without a render thread the closure is called right away.
+ * */
+void vRenderThreadCall(tRenderThread *tRender, fClosure fCall, void *vArg) {
+    uint64_t uTicket;
+
+    if (tRender == NULL) {
+        fCall(vArg);
+        return;
+    }
+
+    // Only one call is handed over at a time, concurrent callers queue up behind it.
+    SDL_LockMutex(tRender->sdlLock);
+    while (tRender->fCall != NULL)
+        SDL_CondWait(tRender->sdlCalled, tRender->sdlLock);
+
+    tRender->fCall = fCall;
+    tRender->vCallArg = vArg;
+    uTicket = ++tRender->uCallsQueued;
+    SDL_CondSignal(tRender->sdlQueued);
+
+    while (tRender->uCallsDone < uTicket)
+        SDL_CondWait(tRender->sdlCalled, tRender->sdlLock);
+    SDL_UnlockMutex(tRender->sdlLock);
+}
+
+/* 
+ *  @brief - presents the last frame, stops the thread and destroys all released textures. NULL is ignored.
+ *
+ *  The renderer itself is kept, like the one created without a render thread.
+ * */
+void vRenderThreadFree(tRenderThread *tRender) {
+    if (tRender == NULL)
+        return;
+
+    // Released textures are destroyed by the thread itself, once it has drawn the last frame.
+    if (tRender->sdlThread != NULL) {
+        SDL_LockMutex(tRender->sdlLock);
+        tRender->bRunning = false;
+        SDL_CondSignal(tRender->sdlQueued);
+        SDL_UnlockMutex(tRender->sdlLock);
+        SDL_WaitThread(tRender->sdlThread, NULL);
+    }
+
+    for (uint32_t i = 0; i < 2; ++i)
+        __vRenderListFree(&tRender->tLists[i]);
+
+    vBatchFree(&tRender->tBatch);
+    if (tRender->sdlCalled != NULL)
+        SDL_DestroyCond(tRender->sdlCalled);
+    if (tRender->sdlQueued != NULL)
+        SDL_DestroyCond(tRender->sdlQueued);
+    if (tRender->sdlSubmitted != NULL)
+        SDL_DestroyCond(tRender->sdlSubmitted);
+    if (tRender->sdlLock != NULL)
+        SDL_DestroyMutex(tRender->sdlLock);
+    free(tRender);
+}
@@ -46,6 +46,7 @@ void vSceneAppendLayer(tScene *sScene, tLayer vLayer) {
  * */
 void vSceneAppendController(tScene *sScene, tController tCtrl) {
     tll_push_front(sScene->lControllers, tCtrl);
+    vControllerIndexAdd(&sScene->tCtrlIndex, &sScene->lControllers.head->item);
 }
 
 /* 
@@ -55,8 +56,11 @@ void vSceneAppendController(tScene *sScene, tController tCtrl) {
  * */
 void vSceneRemoveController(tScene *sScene, uint32_t uControllerID) {
     tll_foreach(sScene->lControllers, c)
-        if (c->item.uControllerID == uControllerID)
+        if (c->item.uControllerID == uControllerID) {
+            vControllerIndexRemove(&sScene->tCtrlIndex, &c->item);
+            vControllerFreeEvents(&c->item);
             tll_remove(sScene->lControllers, c);
+        }
 }
 
 /* 
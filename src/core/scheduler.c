@@ -0,0 +1,233 @@
+/**************************************************************************************************
+ *  File: scheduler.c
+ *  Desc: Timer scheduler of the scene. Sleeping layers and delayed callbacks register their wake-up
+ *  deadline within a binary min-heap keyed on high-resolution ticks, so only due entries are touched.
+ **************************************************************************************************
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ * */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <scheduler.h>
+#include <intrinsics.h>
+#include <log.h>
+
+#define __SCHEDULER_INITIAL_CAPACITY 16
+
+/* Virtual clock in microseconds, which replaces the real one in headless runs. */
+static bool __bSchedulerVirtual = false;
+static uint64_t __uSchedulerVirtualUs = 0;
+
+static inline void __vTimerHeapSwap(tTimerHeap *tHeap, uint32_t a, uint32_t b) {
+    tTimer tTmp = tHeap->tTimers[a];
+    tHeap->tTimers[a] = tHeap->tTimers[b];
+    tHeap->tTimers[b] = tTmp;
+}
+
+static void __vTimerHeapSiftUp(tTimerHeap *tHeap, uint32_t i) {
+    while (i > 0) {
+        uint32_t uParent = (i - 1) / 2;
+        if (tHeap->tTimers[uParent].uDeadline <= tHeap->tTimers[i].uDeadline)
+            break;
+        __vTimerHeapSwap(tHeap, i, uParent);
+        i = uParent;
+    }
+}
+
+static void __vTimerHeapSiftDown(tTimerHeap *tHeap, uint32_t i) {
+    for (;;) {
+        uint32_t uLeft = 2 * i + 1, uRight = uLeft + 1, uMin = i;
+
+        if (uLeft < tHeap->uCount && tHeap->tTimers[uLeft].uDeadline < tHeap->tTimers[uMin].uDeadline)
+            uMin = uLeft;
+        if (uRight < tHeap->uCount && tHeap->tTimers[uRight].uDeadline < tHeap->tTimers[uMin].uDeadline)
+            uMin = uRight;
+        if (uMin == i)
+            break;
+
+        __vTimerHeapSwap(tHeap, i, uMin);
+        i = uMin;
+    }
+}
+
+/* Removes the timer at the heap position, keeping the heap property. */
+static void __vTimerHeapRemoveAt(tTimerHeap *tHeap, uint32_t i) {
+    tHeap->tTimers[i] = tHeap->tTimers[--tHeap->uCount];
+    if (i < tHeap->uCount) {
+        __vTimerHeapSiftDown(tHeap, i);
+        __vTimerHeapSiftUp(tHeap, i);
+    }
+}
+
+static bool __bTimerHeapCancel(tTimerHeap *tHeap, uint32_t uTimerId) {
+    for (uint32_t i = 0; i < tHeap->uCount; ++i)
+        if (tHeap->tTimers[i].uTimerId == uTimerId) {
+            __vTimerHeapRemoveAt(tHeap, i);
+            return true;
+        }
+
+    return false;
+}
+
+static void __vTimerHeapCancelLayer(tTimerHeap *tHeap, tLayer *tLr) {
+    for (uint32_t i = 0; i < tHeap->uCount;)
+        if (tHeap->tTimers[i].tLr == tLr)
+            __vTimerHeapRemoveAt(tHeap, i);
+        else
+            ++i;
+}
+
+static void __vTimerHeapRun(tTimerHeap *tHeap, uint64_t uNow, void *tRun) {
+    while (tHeap->uCount && tHeap->tTimers[0].uDeadline <= uNow) {
+        tTimer tTm = tHeap->tTimers[0];
+
+        if (tTm.uPeriod) {
+            // Periodic timers keep their phase, instead of drifting by the frame time.
+            tHeap->tTimers[0].uDeadline += tTm.uPeriod;
+            if (tHeap->tTimers[0].uDeadline <= uNow)
+                tHeap->tTimers[0].uDeadline = uNow + tTm.uPeriod;
+            __vTimerHeapSiftDown(tHeap, 0);
+        } else
+            __vTimerHeapRemoveAt(tHeap, 0);
+
+        // The callback may add or cancel timers, so the popped copy is used.
+        if (tTm.tLr != NULL)
+            tTm.tLr->bParked = false;
+        if (tTm.fFn != NULL)
+            tTm.fFn(tRun, tTm.vUserData);
+    }
+}
+
+/* 
+ *  @brief - returns the current high-resolution tick.
+ * */
+uint64_t uSchedulerNow(void) {
+    return __bSchedulerVirtual ? __uSchedulerVirtualUs : SDL_GetPerformanceCounter();
+}
+
+/* 
+ *  @brief - converts milliseconds to high-resolution ticks.
+ * */
+uint64_t uSchedulerTicksFromMs(uint32_t ms) {
+    return __bSchedulerVirtual ? (uint64_t)ms * 1000 : SDL_GetPerformanceFrequency() * ms / 1000;
+}
+
+/* 
+ *  @brief - returns the current time in milliseconds. Used by the engine instead of SDL_GetTicks.
+ * */
+uint32_t uSchedulerNowMs(void) {
+    return __bSchedulerVirtual ? (uint32_t)(__uSchedulerVirtualUs / 1000) : SDL_GetTicks();
+}
+
+/* 
+ *  @brief - switches the engine's time to a virtual clock, which only moves with 'vSchedulerAdvanceMs'.
+ *
+ *  Makes runs independent from the wall clock, so they are reproducible. Must be called before any timer is added.
+ * */
+void vSchedulerUseVirtualClock(void) {
+    __bSchedulerVirtual = true;
+    __uSchedulerVirtualUs = 0;
+}
+
+/* 
+ *  @brief - moves the virtual clock forward. Ignored when the real clock is used.
+ * */
+void vSchedulerAdvanceMs(uint32_t ms) {
+    if (__bSchedulerVirtual)
+        __uSchedulerVirtualUs += (uint64_t)ms * 1000;
+}
+
+/* 
+ *  @brief - adds the timer to the heap. Returns it's identifier, or zero on failure.
+ *
+ *  Deadlines of tick counted timers are relative to the scheduler's uTick.
+ * */
+uint32_t uSchedulerAdd(tScheduler *tSched, tTimer tTm) {
+    tTimerHeap *tHeap = tTm.bTicks ? &tSched->tByTick : &tSched->tByTime;
+
+    SDL_AtomicLock(&tSched->iLock);
+    if (tHeap->uCount == tHeap->uCapacity) {
+        uint32_t uNewCapacity = tHeap->uCapacity ? tHeap->uCapacity * 2 : __SCHEDULER_INITIAL_CAPACITY;
+        tTimer *tTimers = realloc(tHeap->tTimers, uNewCapacity * sizeof(tTimer));
+        if (tTimers == NULL) {
+            SDL_AtomicUnlock(&tSched->iLock);
+            vFeatherLogError("Unable to grow the scheduler.");
+            return 0;
+        }
+        tHeap->tTimers = tTimers;
+        tHeap->uCapacity = uNewCapacity;
+    }
+
+    // Zero is reserved for failures.
+    if (++tSched->uNextId == 0)
+        ++tSched->uNextId;
+
+    tTm.uTimerId = tSched->uNextId;
+    tHeap->tTimers[tHeap->uCount] = tTm;
+    __vTimerHeapSiftUp(tHeap, tHeap->uCount++);
+    SDL_AtomicUnlock(&tSched->iLock);
+    return tTm.uTimerId;
+}
+
+/* 
+ *  @brief - removes the pending timer. Returns false if no such timer is pending.
+ * */
+bool bSchedulerCancel(tScheduler *tSched, uint32_t uTimerId) {
+    bool bFound;
+
+    // Cancellation is rare compared to the per tick checks, so the heaps are not indexed by id.
+    SDL_AtomicLock(&tSched->iLock);
+    bFound = __bTimerHeapCancel(&tSched->tByTime, uTimerId) || __bTimerHeapCancel(&tSched->tByTick, uTimerId);
+    SDL_AtomicUnlock(&tSched->iLock);
+    return bFound;
+}
+
+/* 
+ *  @brief - removes all pending wake-ups of the layer, leaving it unparked.
+ * */
+void vSchedulerCancelLayer(tScheduler *tSched, tLayer *tLr) {
+    SDL_AtomicLock(&tSched->iLock);
+    __vTimerHeapCancelLayer(&tSched->tByTime, tLr);
+    __vTimerHeapCancelLayer(&tSched->tByTick, tLr);
+    SDL_AtomicUnlock(&tSched->iLock);
+    tLr->bParked = false;
+}
+
+/* 
+ *  @brief - advances the update tick and pops all due timers, waking up their layers and calling their callbacks.
+ *
+ *  Costs O(log n) per due timer and a single comparison per heap when nothing is due.
+ * */
+void vSchedulerRun(tScheduler *tSched, void *tRun) {
+    // Not locked, since it runs before the layers and callbacks may add timers themselves.
+    tSched->uTick++;
+    __vTimerHeapRun(&tSched->tByTick, tSched->uTick, tRun);
+    __vTimerHeapRun(&tSched->tByTime, uSchedulerNow(), tRun);
+}
+
+/* 
+ *  @brief - frees the heaps without calling any pending callback.
+ * */
+void vSchedulerFree(tScheduler *tSched) {
+    free(tSched->tByTime.tTimers);
+    free(tSched->tByTick.tTimers);
+    *tSched = (tScheduler) {0};
+}
@@ -0,0 +1,343 @@
+/**************************************************************************************************
+ *  File: spatial.c
+ *  Desc: Uniform grid spatial hash. Broadphase for the physics colliders.
+ **************************************************************************************************
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *  
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *  
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ * */
+
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <spatial.h>
+#include <intrinsics.h>
+#include <log.h>
+
+#define __SPATIAL_INITIAL_CAPACITY 64
+
+static inline uint32_t __uSpatialCellHash(int32_t iX, int32_t iY) {
+    return ((uint32_t)iX * 73856093u) ^ ((uint32_t)iY * 19349663u);
+}
+
+static inline int32_t __iSpatialCoord(double d) {
+    return (int32_t)floor(d / FEATHER_PHYSICS_CELL_SIZE);
+}
+
+/* Rebuilds the cell table, dropping emptied cells. The table only grows if most of it is still occupied. */
+static int __iSpatialGrowCells(tSpatialHash *tHash) {
+    tSpatialCell *tOld = tHash->tCells;
+    uint32_t uOldCapacity = tHash->uCellCapacity;
+    uint32_t uNewCapacity = __SPATIAL_INITIAL_CAPACITY;
+    uint32_t uLive = 0;
+
+    for (uint32_t i = 0; i < uOldCapacity; ++i)
+        uLive += tOld[i].bUsed && tOld[i].uCount;
+
+    while ((uLive + 1) * 2 > uNewCapacity)
+        uNewCapacity *= 2;
+    if (uNewCapacity < uOldCapacity)
+        uNewCapacity = uOldCapacity;
+
+    tSpatialCell *tNew = calloc(uNewCapacity, sizeof(tSpatialCell));
+    if (tNew == NULL)
+        return -1;
+
+    for (uint32_t i = 0; i < uOldCapacity; ++i) {
+        if (!tOld[i].bUsed)
+            continue;
+
+        // Cells left by all colliders are recycled here instead of when they empty, so colliders
+        // moving back and forth over a cell border don't allocate every time.
+        if (tOld[i].uCount == 0) {
+            free(tOld[i].uItems);
+            continue;
+        }
+
+        uint32_t uSlot = __uSpatialCellHash(tOld[i].iX, tOld[i].iY) & (uNewCapacity - 1);
+        while (tNew[uSlot].bUsed)
+            uSlot = (uSlot + 1) & (uNewCapacity - 1);
+        tNew[uSlot] = tOld[i];
+    }
+
+    free(tOld);
+    tHash->tCells = tNew;
+    tHash->uCells = uLive;
+    tHash->uCellCapacity = uNewCapacity;
+    return 0;
+}
+
+/* Finds the cell, creating it if requested. Returns NULL if the cell doesn't exist. */
+static tSpatialCell* __tSpatialCell(tSpatialHash *tHash, int32_t iX, int32_t iY, bool bCreate) {
+    uint32_t uSlot;
+
+    if (bCreate && (tHash->uCells + 1) * 4 > tHash->uCellCapacity * 3)
+        if (__iSpatialGrowCells(tHash) < 0)
+            return NULL;
+
+    if (tHash->uCellCapacity == 0)
+        return NULL;
+
+    uSlot = __uSpatialCellHash(iX, iY) & (tHash->uCellCapacity - 1);
+    while (tHash->tCells[uSlot].bUsed) {
+        if (tHash->tCells[uSlot].iX == iX && tHash->tCells[uSlot].iY == iY)
+            return &tHash->tCells[uSlot];
+        uSlot = (uSlot + 1) & (tHash->uCellCapacity - 1);
+    }
+
+    if (!bCreate)
+        return NULL;
+
+    tHash->tCells[uSlot] = (tSpatialCell) { .iX = iX, .iY = iY, .bUsed = true };
+    tHash->uCells++;
+    return &tHash->tCells[uSlot];
+}
+
+static void __vSpatialLink(tSpatialHash *tHash, uint32_t uEntry, int32_t iX, int32_t iY) {
+    tSpatialCell *tCell = __tSpatialCell(tHash, iX, iY, true);
+    if (tCell == NULL) {
+        vFeatherLogError("Unable to grow the spatial hash.");
+        return;
+    }
+
+    if (tCell->uCount == tCell->uCapacity) {
+        uint32_t uNewCapacity = tCell->uCapacity ? tCell->uCapacity * 2 : 4;
+        uint32_t *uItems = realloc(tCell->uItems, uNewCapacity * sizeof(uint32_t));
+        if (uItems == NULL) {
+            vFeatherLogError("Unable to grow the spatial cell.");
+            return;
+        }
+        tCell->uItems = uItems;
+        tCell->uCapacity = uNewCapacity;
+    }
+
+    tCell->uItems[tCell->uCount++] = uEntry;
+}
+
+static void __vSpatialUnlink(tSpatialHash *tHash, uint32_t uEntry, int32_t iX, int32_t iY) {
+    tSpatialCell *tCell = __tSpatialCell(tHash, iX, iY, false);
+    if (tCell == NULL)
+        return;
+
+    for (uint32_t i = 0; i < tCell->uCount; ++i)
+        if (tCell->uItems[i] == uEntry) {
+            tCell->uItems[i] = tCell->uItems[--tCell->uCount];
+            return;
+        }
+}
+
+static inline bool __bSpatialCovers(tSpatialEntry *tEntry, int32_t iX, int32_t iY) {
+    return iX >= tEntry->iMinX && iX <= tEntry->iMaxX && iY >= tEntry->iMinY && iY <= tEntry->iMaxY;
+}
+
+/* 
+ *  @brief - inserts a new collider. Returns it's entry index or UINT32_MAX on failure.
+ * */
+uint32_t uSpatialInsert(tSpatialHash *tHash, tColliderLabel tLabel) {
+    uint32_t uEntry;
+
+    if (tHash->uEntries == tHash->uEntryCapacity && tHash->uFreeCount == 0) {
+        uint32_t uNewCapacity = tHash->uEntryCapacity ? tHash->uEntryCapacity * 2 : __SPATIAL_INITIAL_CAPACITY;
+        tSpatialEntry *tEntries = realloc(tHash->tEntries, uNewCapacity * sizeof(tSpatialEntry));
+        if (tEntries == NULL) {
+            vFeatherLogError("Unable to grow the spatial hash entries.");
+            return UINT32_MAX;
+        }
+        tHash->tEntries = tEntries;
+
+        uint32_t *uFree = realloc(tHash->uFree, uNewCapacity * sizeof(uint32_t));
+        if (uFree == NULL) {
+            vFeatherLogError("Unable to grow the spatial hash entries.");
+            return UINT32_MAX;
+        }
+        tHash->uFree = uFree;
+        tHash->uEntryCapacity = uNewCapacity;
+    }
+
+    // Reusing removed entries first, so indices stay compact.
+    uEntry = tHash->uFreeCount ? tHash->uFree[--tHash->uFreeCount] : tHash->uEntries++;
+
+    tSpatialEntry *tEntry = &tHash->tEntries[uEntry];
+    *tEntry = (tSpatialEntry) {
+        .tLabel = tLabel,
+        .iMinX = __iSpatialCoord(tLabel.x),
+        .iMinY = __iSpatialCoord(tLabel.y),
+        .iMaxX = __iSpatialCoord(tLabel.x + tLabel.w),
+        .iMaxY = __iSpatialCoord(tLabel.y + tLabel.h),
+        .bUsed = true,
+    };
+
+    for (int32_t iX = tEntry->iMinX; iX <= tEntry->iMaxX; ++iX)
+        for (int32_t iY = tEntry->iMinY; iY <= tEntry->iMaxY; ++iY)
+            __vSpatialLink(tHash, uEntry, iX, iY);
+
+    return uEntry;
+}
+
+/* 
+ *  @brief - moves the collider to new bounds, relinking only the cells that changed.
+ * */
+void vSpatialUpdate(tSpatialHash *tHash, uint32_t uEntry, double x, double y, double w, double h) {
+    tSpatialEntry *tEntry = &tHash->tEntries[uEntry];
+    tSpatialEntry tOld = *tEntry;
+
+    tEntry->tLabel.x = x;
+    tEntry->tLabel.y = y;
+    tEntry->tLabel.w = w;
+    tEntry->tLabel.h = h;
+    tEntry->iMinX = __iSpatialCoord(x);
+    tEntry->iMinY = __iSpatialCoord(y);
+    tEntry->iMaxX = __iSpatialCoord(x + w);
+    tEntry->iMaxY = __iSpatialCoord(y + h);
+
+    // Most updates stay within the same cells.
+    if (tOld.iMinX == tEntry->iMinX && tOld.iMinY == tEntry->iMinY && 
+        tOld.iMaxX == tEntry->iMaxX && tOld.iMaxY == tEntry->iMaxY)
+        return;
+
+    for (int32_t iX = tOld.iMinX; iX <= tOld.iMaxX; ++iX)
+        for (int32_t iY = tOld.iMinY; iY <= tOld.iMaxY; ++iY)
+            if (!__bSpatialCovers(tEntry, iX, iY))
+                __vSpatialUnlink(tHash, uEntry, iX, iY);
+
+    for (int32_t iX = tEntry->iMinX; iX <= tEntry->iMaxX; ++iX)
+        for (int32_t iY = tEntry->iMinY; iY <= tEntry->iMaxY; ++iY)
+            if (!__bSpatialCovers(&tOld, iX, iY))
+                __vSpatialLink(tHash, uEntry, iX, iY);
+}
+
+/* 
+ *  @brief - removes the collider from the hash. It's entry index may be reused.
+ * */
+void vSpatialRemove(tSpatialHash *tHash, uint32_t uEntry) {
+    tSpatialEntry *tEntry = &tHash->tEntries[uEntry];
+    if (!tEntry->bUsed)
+        return;
+
+    for (int32_t iX = tEntry->iMinX; iX <= tEntry->iMaxX; ++iX)
+        for (int32_t iY = tEntry->iMinY; iY <= tEntry->iMaxY; ++iY)
+            __vSpatialUnlink(tHash, uEntry, iX, iY);
+
+    tEntry->bUsed = false;
+    tHash->uFree[tHash->uFreeCount++] = uEntry;
+}
+
+/* Stores the entry at the provided position of the result buffer, growing it if needed. */
+static bool __bSpatialPushResult(tSpatialHash *tHash, uint32_t uFound, uint32_t uEntry) {
+    if (uFound == tHash->uResultCapacity) {
+        uint32_t uNewCapacity = tHash->uResultCapacity ? tHash->uResultCapacity * 2 : __SPATIAL_INITIAL_CAPACITY;
+        uint32_t *uResults = realloc(tHash->uResults, uNewCapacity * sizeof(uint32_t));
+        if (uResults == NULL) {
+            vFeatherLogError("Unable to grow the spatial query buffer.");
+            return false;
+        }
+        tHash->uResults = uResults;
+        tHash->uResultCapacity = uNewCapacity;
+    }
+
+    tHash->uResults[uFound] = uEntry;
+    return true;
+}
+
+/* 
+ *  @brief - collects other colliders of the same group sharing a cell with the provided one.
+ *
+ *  @tHash      - spatial hash.
+ *  @uEntry     - collider to query around.
+ *  @uOut       - receives the internal buffer of entry indices, valid until the next query.
+ *
+ *  Returns the amount of candidates. Candidates still have to pass the narrowphase.
+ * */
+uint32_t uSpatialQuery(tSpatialHash *tHash, uint32_t uEntry, uint32_t **uOut) {
+    tSpatialEntry *tEntry = &tHash->tEntries[uEntry];
+    uint32_t uFound = 0;
+
+    // Each query gets a fresh stamp, so entries covering several cells are reported once.
+    tHash->uStamp++;
+    tEntry->uStamp = tHash->uStamp;
+
+    for (int32_t iX = tEntry->iMinX; iX <= tEntry->iMaxX; ++iX)
+        for (int32_t iY = tEntry->iMinY; iY <= tEntry->iMaxY; ++iY) {
+            tSpatialCell *tCell = __tSpatialCell(tHash, iX, iY, false);
+            if (tCell == NULL)
+                continue;
+
+            for (uint32_t i = 0; i < tCell->uCount; ++i) {
+                tSpatialEntry *tOther = &tHash->tEntries[tCell->uItems[i]];
+                if (tOther->uStamp == tHash->uStamp || tOther->tLabel.uCollidersGroup != tEntry->tLabel.uCollidersGroup)
+                    continue;
+                tOther->uStamp = tHash->uStamp;
+
+                if (!__bSpatialPushResult(tHash, uFound, tCell->uItems[i])) {
+                    *uOut = tHash->uResults;
+                    return uFound;
+                }
+                uFound++;
+            }
+        }
+
+    *uOut = tHash->uResults;
+    return uFound;
+}
+
+/* 
+ *  @brief - collects all entries, regardless of their group, whose bounds contain the point.
+ *
+ *  @tHash      - spatial hash.
+ *  @x, y       - queried point.
+ *  @uOut       - receives the internal buffer of entry indices, valid until the next query.
+ *
+ *  Only the single cell under the point is visited. Returns the amount of entries found.
+ * */
+uint32_t uSpatialQueryPoint(tSpatialHash *tHash, double x, double y, uint32_t **uOut) {
+    tSpatialCell *tCell = __tSpatialCell(tHash, __iSpatialCoord(x), __iSpatialCoord(y), false);
+    uint32_t uFound = 0;
+
+    *uOut = tHash->uResults;
+    if (tCell == NULL)
+        return 0;
+
+    for (uint32_t i = 0; i < tCell->uCount; ++i) {
+        tColliderLabel *tLabel = &tHash->tEntries[tCell->uItems[i]].tLabel;
+        if (x < tLabel->x || x > tLabel->x + tLabel->w || y < tLabel->y || y > tLabel->y + tLabel->h)
+            continue;
+
+        if (!__bSpatialPushResult(tHash, uFound, tCell->uItems[i]))
+            break;
+        uFound++;
+    }
+
+    *uOut = tHash->uResults;
+    return uFound;
+}
+
+/* 
+ *  @brief - frees all memory owned by the hash.
+ * */
+void vSpatialFree(tSpatialHash *tHash) {
+    for (uint32_t i = 0; i < tHash->uCellCapacity; ++i)
+        free(tHash->tCells[i].uItems);
+
+    free(tHash->tCells);
+    free(tHash->tEntries);
+    free(tHash->uFree);
+    free(tHash->uResults);
+    *tHash = (tSpatialHash) {0};
+}
@@ -0,0 +1,219 @@
+/**************************************************************************************************
+ *  File: texture.c
+ *  Desc: Shared texture cache. Textures are loaded once per path and handed out to every rect that
+ *  requests the same image, with a reference count deciding when the GPU texture can be destroyed.
+ **************************************************************************************************
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ * */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <texture.h>
+#include <intrinsics.h>
+#include <log.h>
+
+#define __TEXTURE_CACHE_INITIAL_CAPACITY 16
+
+/* FNV-1a hash over the path string. */
+static uint32_t __uTextureHash(const char *sPath) {
+    uint32_t uHash = 2166136261u;
+    while (*sPath) {
+        uHash ^= (uint8_t)*sPath++;
+        uHash *= 16777619u;
+    }
+    return uHash;
+}
+
+/* Returns the slot holding the path, or the empty slot where it shall be inserted. */
+static uint32_t __uTextureSlot(tTextureCache *tCache, const char *sPath) {
+    uint32_t uMask = tCache->uCapacity - 1;
+    uint32_t uSlot = __uTextureHash(sPath) & uMask;
+
+    while (tCache->tEntries[uSlot].sPath != NULL && strcmp(tCache->tEntries[uSlot].sPath, sPath) != 0)
+        uSlot = (uSlot + 1) & uMask;
+
+    return uSlot;
+}
+
+static void __vTextureDestroy(tTextureCache *tCache, SDL_Texture *sdlTexture) {
+    if (tCache->fDestroy != NULL)
+        tCache->fDestroy(tCache->vDestroyCtx, sdlTexture);
+    else
+        SDL_DestroyTexture(sdlTexture);
+}
+
+static int __iTextureCacheGrow(tTextureCache *tCache) {
+    tTexture *tOld = tCache->tEntries;
+    uint32_t uOldCapacity = tCache->uCapacity;
+    uint32_t uNewCapacity = uOldCapacity ? uOldCapacity * 2 : __TEXTURE_CACHE_INITIAL_CAPACITY;
+
+    tTexture *tNew = calloc(uNewCapacity, sizeof(tTexture));
+    if (tNew == NULL)
+        return -1;
+
+    tCache->tEntries = tNew;
+    tCache->uCapacity = uNewCapacity;
+
+    for (uint32_t i = 0; i < uOldCapacity; ++i)
+        if (tOld[i].sPath != NULL)
+            tNew[__uTextureSlot(tCache, tOld[i].sPath)] = tOld[i];
+
+    free(tOld);
+    return 0;
+}
+
+/*
+ *  @brief - obtains a texture for the provided path, loading it on the first request.
+ *
+ *  @tCache     - runtime's texture cache.
+ *  @sdlRend    - renderer used to upload the texture on a cache miss.
+ *  @sPath      - path to the texture source.
+ *
+ *  Increments the reference count of the texture. Returns NULL if the texture can't be loaded.
+ * */
+tTexture* tTextureCacheAcquire(tTextureCache *tCache, SDL_Renderer *sdlRend, const char *sPath) {
+    uint32_t uSlot;
+    tTexture *tTex;
+
+    // Keeping the load factor under 3/4 so probing sequences stay short.
+    if ((tCache->uCount + 1) * 4 > tCache->uCapacity * 3)
+        if (__iTextureCacheGrow(tCache) < 0) {
+            vFeatherLogError("Unable to grow the texture cache.");
+            return NULL;
+        }
+
+    uSlot = __uTextureSlot(tCache, sPath);
+    tTex = &tCache->tEntries[uSlot];
+
+    if (tTex->sPath != NULL) {
+        tTex->uRefCount++;
+        return tTex;
+    }
+
+    SDL_Surface *sdlSurf = IMG_Load(sPath);
+    if (!sdlSurf) {
+        vFeatherLogError("Unable to load rect texture: %s", IMG_GetError());
+        return NULL;
+    }
+
+    SDL_Texture *sdlTexture = SDL_CreateTextureFromSurface(sdlRend, sdlSurf);
+    if (!sdlTexture) {
+        vFeatherLogError("Unable to create texture from surface: %s", SDL_GetError());
+        SDL_FreeSurface(sdlSurf);
+        return NULL;
+    }
+
+    *tTex = (tTexture) {
+        .sPath = strdup(sPath),
+        .sdlTexture = sdlTexture,
+        .uWidth = sdlSurf->w,
+        .uHeight = sdlSurf->h,
+        .uRefCount = 1,
+    };
+    SDL_FreeSurface(sdlSurf);
+    tCache->uCount++;
+
+    vFeatherLogInfo("Loading asset: Rect texture: %s...", strrchr(sPath, '/') + 1);
+    return tTex;
+}
+
+/*
+ *  @brief - drops one reference of the texture under the provided path.
+ *
+ *  The texture is destroyed once the last reference is released. Returns false if the path is not
+ *  owned by the cache, so the caller knows that the texture must be destroyed manually.
+ * */
+bool bTextureCacheRelease(tTextureCache *tCache, const char *sPath) {
+    uint32_t uMask, uSlot, uNext;
+
+    if (sPath == NULL || tCache->uCount == 0)
+        return false;
+
+    uMask = tCache->uCapacity - 1;
+    uSlot = __uTextureSlot(tCache, sPath);
+    if (tCache->tEntries[uSlot].sPath == NULL)
+        return false;
+
+    if (--tCache->tEntries[uSlot].uRefCount)
+        return true;
+
+    __vTextureDestroy(tCache, tCache->tEntries[uSlot].sdlTexture);
+    free(tCache->tEntries[uSlot].sPath);
+    tCache->tEntries[uSlot] = (tTexture) {0};
+    tCache->uCount--;
+
+    // Backward shift deletion, so no tombstones are left within the probing sequences.
+    for (uNext = (uSlot + 1) & uMask; tCache->tEntries[uNext].sPath != NULL; uNext = (uNext + 1) & uMask) {
+        uint32_t uHome = __uTextureHash(tCache->tEntries[uNext].sPath) & uMask;
+
+        if (((uNext - uHome) & uMask) >= ((uNext - uSlot) & uMask)) {
+            tCache->tEntries[uSlot] = tCache->tEntries[uNext];
+            tCache->tEntries[uNext] = (tTexture) {0};
+            uSlot = uNext;
+        }
+    }
+
+    return true;
+}
+
+/*
+ *  @brief - returns the shared 1x1 white texture, creating it on the first call.
+ *
+ *  The texture is not reference counted and lives as long as the cache itself. Solid color rects
+ *  tint it with their color instead of owning a texture of their own.
+ * */
+SDL_Texture* sdlTextureCacheWhite(tTextureCache *tCache, SDL_Renderer *sdlRend) {
+    if (tCache->sdlWhite != NULL)
+        return tCache->sdlWhite;
+
+    SDL_Surface *sdlSurf = SDL_CreateRGBSurfaceWithFormat(0, 1, 1, 32, SDL_PIXELFORMAT_RGBA32);
+    if (!sdlSurf) {
+        vFeatherLogError("Unable to create surface for solid colors: %s", SDL_GetError());
+        return NULL;
+    }
+
+    SDL_FillRect(sdlSurf, NULL, SDL_MapRGBA(sdlSurf->format, 255, 255, 255, 255));
+    tCache->sdlWhite = SDL_CreateTextureFromSurface(sdlRend, sdlSurf);
+    SDL_FreeSurface(sdlSurf);
+
+    if (tCache->sdlWhite == NULL)
+        vFeatherLogError("Unable to create texture for solid colors: %s", SDL_GetError());
+
+    return tCache->sdlWhite;
+}
+
+/*
+ *  @brief - destroys all cached textures regardless of their reference count.
+ * */
+void vTextureCacheFree(tTextureCache *tCache) {
+    for (uint32_t i = 0; i < tCache->uCapacity; ++i)
+        if (tCache->tEntries[i].sPath != NULL) {
+            SDL_DestroyTexture(tCache->tEntries[i].sdlTexture);
+            free(tCache->tEntries[i].sPath);
+        }
+
+    if (tCache->sdlWhite != NULL)
+        SDL_DestroyTexture(tCache->sdlWhite);
+
+    free(tCache->tEntries);
+    *tCache = (tTextureCache) {0};
+}
@@ -134,12 +134,32 @@ static void vInitEvent(tLogEvent *tEv, void *vUserData) {
         tEv->tTime = localtime(&tCurrentTime);
     }
     tEv->vUserData = vUserData;
-} __attribute__((visibility("internal")))
+}
 
-/* 
- *  @brief - Performs the actual logging logic.
- */
-void __feather_log(int iLevel, const char *cFile, int iLine, const char *cFmt, ...) {
+__attribute__((visibility("internal")))
+void __feather_log(int iLevel, const char *cFile, int iLine, const char *cFmt, ...);
+
+/* Hands the event to stderr and all callbacks. Must be called under the user's lock. */
+static void __vLogDispatch(tLogEvent *tEv, va_list vaAp) {
+    if (!tLogger.bQuiet && tEv->iLevel >= tLogger.iLevel) {
+        vInitEvent(tEv, stderr);
+        va_copy(tEv->vaAp, vaAp);
+        vStdoutCallback(tEv);
+        va_end(tEv->vaAp);
+    }
+
+    for (int i = 0; i < FEATHER_LOG_MAX_CALLBACKS && tLogger.tCallbacks[i].vFn; i++) {
+        tCallback *tCb = &tLogger.tCallbacks[i];
+        if (tEv->iLevel >= tCb->iLevel) {
+            vInitEvent(tEv, tCb->vUserData);
+            va_copy(tEv->vaAp, vaAp);
+            tCb->vFn(tEv);
+            va_end(tEv->vaAp);
+        }
+    }
+}
+
+static void __vLogSync(int iLevel, const char *cFile, int iLine, const char *cFmt, va_list vaAp) {
     tLogEvent tEv = {
         .cFmt   = cFmt,
         .cFile  = cFile,
@@ -148,24 +168,539 @@ void __feather_log(int iLevel, const char *cFile, int iLine, const char *cFmt, .
     };
 
     vLOCK(tLogger.vLock, tLogger.vUserData);
+    __vLogDispatch(&tEv, vaAp);
+    vUNLOCK(tLogger.vLock, tLogger.vUserData);
+}
+
+#if FEATHER_LOG_ASYNC
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+#if FEATHER_LOG_ASYNC_CAPACITY & (FEATHER_LOG_ASYNC_CAPACITY - 1)
+#error "[FEATHER_LOG_ASYNC_CAPACITY] must be a power of two."
+#endif
+
+#define __LOG_MAX_ARGS 16
+#define __LOG_STRINGS_SIZE 256
+
+/* Captured argument types. Integers are widened, so they are formatted with the 'll' modifier. */
+enum { __lARG_INT, __lARG_UINT, __lARG_DOUBLE, __lARG_STR, __lARG_PTR };
+
+/* 
+ *  @brief - one message waiting to be formatted by the logging thread.
+ *
+ *  Only the format pointer is kept, so formats must be string literals. String arguments are
+ *  copied, since they may be gone until the message is formatted.
+ * */
+typedef struct {
+    const char *cFmt;
+    const char *cFile;
+    time_t tTime;
+    int iLine, iLevel;
+    uint8_t uArgs;
+    uint8_t uTypes[__LOG_MAX_ARGS];
+    union {
+        long long i;
+        unsigned long long u;
+        double d;
+        const void *p;
+        uint16_t s;
+    } uValues[__LOG_MAX_ARGS];
+    uint16_t uStringsUsed;
+    char cStrings[__LOG_STRINGS_SIZE];
+} tLogRecord;
+
+/* Vyukov's bounded queue cell. The sequence tells producers and the consumer who owns it. */
+typedef struct {
+    atomic_size_t uSeq;
+    tLogRecord tRec;
+} tLogCell;
+
+static struct {
+    tLogCell tCells[FEATHER_LOG_ASYNC_CAPACITY];
+    atomic_size_t uEnqueue;
+    atomic_size_t uDequeue;
+    atomic_uint uDropped;
+    atomic_int iState;
+    atomic_bool bRunning;
+    atomic_bool bSleeping;
+    eLogFullPolicy ePolicy;
+    SDL_Thread *sdlThread;
+    SDL_sem *sdlWake;
+    SDL_mutex *sdlFlushLock;
+    SDL_cond *sdlFlushed;
+    unsigned long uThreadId;
+} tAsync;
+
+enum { __lASYNC_STOPPED, __lASYNC_STARTING, __lASYNC_STARTED, __lASYNC_CLOSED };
+
+static int __iLogThread(void *vData);
+
+/* Copies the arguments described by the format into the record. */
+static void __vLogCapture(tLogRecord *tRec, const char *cFmt, va_list vaAp) {
+    for (const char *c = cFmt; *c; ++c) {
+        int iLong = 0, iShort = 0;
+
+        if (*c != '%')
+            continue;
+        if (*++c == '%')
+            continue;
+
+        int iPrecision = -1;
+
+        while (*c && strchr("-+ #0'", *c))
+            ++c;
+
+        // Star width and precision are consumed as integer arguments.
+        for (int iPart = 0; iPart < 2; ++iPart) {
+            int iValue = 0;
+
+            if (*c == '*') {
+                iValue = va_arg(vaAp, int);
+                if (tRec->uArgs < __LOG_MAX_ARGS) {
+                    tRec->uTypes[tRec->uArgs] = __lARG_INT;
+                    tRec->uValues[tRec->uArgs++].i = iValue;
+                }
+                ++c;
+            }
+            for (; *c >= '0' && *c <= '9'; ++c)
+                iValue = iValue * 10 + (*c - '0');
 
-    if (!tLogger.bQuiet && iLevel >= tLogger.iLevel) {
-        vInitEvent(&tEv, stderr);
-        va_start(tEv.vaAp, cFmt);
-        vStdoutCallback(&tEv);
-        va_end(tEv.vaAp);
+            // A negative star precision is taken as if the precision was omitted.
+            if (iPart == 1)
+                iPrecision = iValue < 0 ? -1 : iValue;
+            if (iPart == 0 && *c == '.')
+                ++c;
+            else
+                break;
+        }
+
+        for (; *c && strchr("hlLzjt", *c); ++c) {
+            if (*c == 'h') iShort++;
+            else if (*c == 'l') iLong++;
+            else iLong = 2;
+        }
+
+        if (*c == '\0' || tRec->uArgs == __LOG_MAX_ARGS)
+            break;
+
+        uint8_t uArg = tRec->uArgs++;
+        switch (*c) {
+            case 'd': case 'i':
+                tRec->uTypes[uArg] = __lARG_INT;
+                tRec->uValues[uArg].i = iLong > 1 ? va_arg(vaAp, long long) : iLong ? va_arg(vaAp, long) : va_arg(vaAp, int);
+                if (iShort == 1) tRec->uValues[uArg].i = (short)tRec->uValues[uArg].i;
+                if (iShort > 1) tRec->uValues[uArg].i = (signed char)tRec->uValues[uArg].i;
+                break;
+            case 'u': case 'x': case 'X': case 'o': case 'c':
+                tRec->uTypes[uArg] = *c == 'c' ? __lARG_INT : __lARG_UINT;
+                tRec->uValues[uArg].u = iLong > 1 ? va_arg(vaAp, unsigned long long) : iLong ? va_arg(vaAp, unsigned long) : va_arg(vaAp, unsigned);
+                if (iShort == 1) tRec->uValues[uArg].u = (unsigned short)tRec->uValues[uArg].u;
+                if (iShort > 1) tRec->uValues[uArg].u = (unsigned char)tRec->uValues[uArg].u;
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                tRec->uTypes[uArg] = __lARG_DOUBLE;
+                tRec->uValues[uArg].d = iLong == 2 ? (double)va_arg(vaAp, long double) : va_arg(vaAp, double);
+                break;
+            case 's': {
+                const char *sArg = va_arg(vaAp, const char*);
+                size_t uFree = __LOG_STRINGS_SIZE - tRec->uStringsUsed;
+                size_t uLen;
+
+                // With a precision, the argument doesn't have to be null-terminated.
+                if (!sArg)
+                    uLen = 6;
+                else if (iPrecision >= 0)
+                    uLen = strnlen(sArg, iPrecision);
+                else
+                    uLen = strlen(sArg);
+
+                // Strings not fitting into the record are truncated, a full record formats them as empty.
+                if (uLen >= uFree)
+                    uLen = uFree ? uFree - 1 : 0;
+                tRec->uTypes[uArg] = __lARG_STR;
+                tRec->uValues[uArg].s = uFree ? tRec->uStringsUsed : __LOG_STRINGS_SIZE;
+                if (uFree) {
+                    memcpy(&tRec->cStrings[tRec->uStringsUsed], sArg ? sArg : "(null)", uLen);
+                    tRec->cStrings[tRec->uStringsUsed + uLen] = '\0';
+                    tRec->uStringsUsed += uLen + 1;
+                }
+                break;
+            }
+            default:
+                tRec->uTypes[uArg] = __lARG_PTR;
+                tRec->uValues[uArg].p = va_arg(vaAp, const void*);
+                break;
+        }
     }
+}
 
-    for (int i = 0; i < FEATHER_LOG_MAX_CALLBACKS && tLogger.tCallbacks[i].vFn; i++) {
-        tCallback *tCb = &tLogger.tCallbacks[i];
-        if (iLevel >= tCb->iLevel) {
-            vInitEvent(&tEv, tCb->vUserData);
-            va_start(tEv.vaAp, cFmt);
-            tCb->vFn(&tEv);
-            va_end(tEv.vaAp);
+/* Formats the record into the buffer, one conversion at a time. */
+static void __vLogFormat(tLogRecord *tRec, char *cOut, size_t uSize) {
+    size_t uLen = 0;
+    uint8_t uArg = 0;
+    char cSpec[64];
+
+#define __LOG_PUT(...)                                                      \
+    do {                                                                    \
+        int iWritten = snprintf(cOut + uLen, uSize - uLen, __VA_ARGS__);    \
+        if (iWritten > 0) uLen += iWritten;                                 \
+        if (uLen >= uSize) return;                                          \
+    } while (0)
+
+    cOut[0] = '\0';
+    for (const char *c = tRec->cFmt; *c; ++c) {
+        size_t uSpec = 0;
+
+        if (*c != '%' || c[1] == '%') {
+            c += *c == '%';
+            if (uLen + 1 < uSize) {
+                cOut[uLen++] = *c;
+                cOut[uLen] = '\0';
+            }
+            continue;
+        }
+
+        // Rebuilding the conversion with resolved stars and the widened length modifier.
+        cSpec[uSpec++] = *c++;
+        for (; *c && !strchr("diuxXocfFeEgGaAspn", *c) && uSpec < sizeof(cSpec) - 24; ++c) {
+            if (*c == '*')
+                uSpec += snprintf(&cSpec[uSpec], 12, "%lld", uArg < tRec->uArgs ? tRec->uValues[uArg++].i : 0);
+            else if (!strchr("hlLzjt", *c))
+                cSpec[uSpec++] = *c;
         }
+
+        if (*c == '\0' || uArg >= tRec->uArgs)
+            return;
+
+        switch (tRec->uTypes[uArg]) {
+            case __lARG_INT:
+            case __lARG_UINT:
+                if (*c != 'c') {
+                    cSpec[uSpec++] = 'l';
+                    cSpec[uSpec++] = 'l';
+                }
+                cSpec[uSpec++] = *c;
+                cSpec[uSpec] = '\0';
+                if (*c == 'c') __LOG_PUT(cSpec, (int)tRec->uValues[uArg].i);
+                else __LOG_PUT(cSpec, tRec->uValues[uArg].i);
+                break;
+            case __lARG_DOUBLE:
+                cSpec[uSpec++] = *c;
+                cSpec[uSpec] = '\0';
+                __LOG_PUT(cSpec, tRec->uValues[uArg].d);
+                break;
+            case __lARG_STR:
+                cSpec[uSpec++] = 's';
+                cSpec[uSpec] = '\0';
+                __LOG_PUT(cSpec, tRec->uValues[uArg].s < __LOG_STRINGS_SIZE ? &tRec->cStrings[tRec->uValues[uArg].s] : "");
+                break;
+            default:
+                __LOG_PUT("%p", tRec->uValues[uArg].p);
+                break;
+        }
+        ++uArg;
     }
+#undef __LOG_PUT
+}
 
-    vUNLOCK(tLogger.vLock, tLogger.vUserData);
+/* Variadic trampoline, so the formatted message can be passed to the callbacks as a va_list. */
+static void __vLogDispatchFormatted(tLogEvent *tEv, ...) {
+    va_list vaAp;
+    va_start(vaAp, tEv);
+    __vLogDispatch(tEv, vaAp);
+    va_end(vaAp);
 }
 
+/* Pops and dispatches all queued records. Returns false if the queue was empty. */
+static bool __bLogDrain(void) {
+    char cMessage[1024];
+    bool bAny = false;
+    unsigned uDropped;
+
+    for (;;) {
+        size_t uDequeue = atomic_load_explicit(&tAsync.uDequeue, memory_order_relaxed);
+        tLogCell *tCell = &tAsync.tCells[uDequeue & (FEATHER_LOG_ASYNC_CAPACITY - 1)];
+        size_t uSeq = atomic_load_explicit(&tCell->uSeq, memory_order_acquire);
+
+        if ((intptr_t)(uSeq - (uDequeue + 1)) < 0)
+            break;
+
+        tLogRecord *tRec = &tCell->tRec;
+        struct tm tTime;
+        localtime_r(&tRec->tTime, &tTime);
+        __vLogFormat(tRec, cMessage, sizeof(cMessage));
+
+        tLogEvent tEv = {
+            .cFmt   = "%s",
+            .cFile  = tRec->cFile,
+            .iLine  = tRec->iLine,
+            .iLevel = tRec->iLevel,
+            .tTime  = &tTime,
+        };
+
+        // The cell is only released after the record was fully read.
+        atomic_store_explicit(&tCell->uSeq, uDequeue + FEATHER_LOG_ASYNC_CAPACITY, memory_order_release);
+
+        vLOCK(tLogger.vLock, tLogger.vUserData);
+        __vLogDispatchFormatted(&tEv, cMessage);
+        vUNLOCK(tLogger.vLock, tLogger.vUserData);
+
+        // Published after the dispatch, so flushing waits for the message to be written.
+        atomic_store_explicit(&tAsync.uDequeue, uDequeue + 1, memory_order_release);
+        bAny = true;
+    }
+
+    if (bAny) {
+        SDL_LockMutex(tAsync.sdlFlushLock);
+        SDL_CondBroadcast(tAsync.sdlFlushed);
+        SDL_UnlockMutex(tAsync.sdlFlushLock);
+    }
+
+    uDropped = atomic_exchange_explicit(&tAsync.uDropped, 0, memory_order_relaxed);
+    if (uDropped) {
+        time_t tNow = time(NULL);
+        struct tm tTime;
+        localtime_r(&tNow, &tTime);
+        tLogEvent tEv = { .cFmt = "%s", .cFile = __FILE__, .iLine = __LINE__, .iLevel = lWARN, .tTime = &tTime };
+        snprintf(cMessage, sizeof(cMessage), "%u log messages were dropped, the log queue was full.", uDropped);
+
+        vLOCK(tLogger.vLock, tLogger.vUserData);
+        __vLogDispatchFormatted(&tEv, cMessage);
+        vUNLOCK(tLogger.vLock, tLogger.vUserData);
+    }
+
+    return bAny;
+}
+
+/* Returns true if the consumer has work, a published record or dropped messages to report. */
+static bool __bLogPending(void) {
+    size_t uDequeue = atomic_load_explicit(&tAsync.uDequeue, memory_order_relaxed);
+    tLogCell *tCell = &tAsync.tCells[uDequeue & (FEATHER_LOG_ASYNC_CAPACITY - 1)];
+
+    return atomic_load_explicit(&tCell->uSeq, memory_order_acquire) == uDequeue + 1 ||
+        atomic_load_explicit(&tAsync.uDropped, memory_order_relaxed);
+}
+
+/* Wakes the logging thread if it went to sleep. Called after a record was published. */
+static void __vLogWake(void) {
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_exchange(&tAsync.bSleeping, false))
+        SDL_SemPost(tAsync.sdlWake);
+}
+
+static int __iLogThread(void *vData) {
+    (void)vData;
+    tAsync.uThreadId = SDL_ThreadID();
+    while (atomic_load_explicit(&tAsync.bRunning, memory_order_acquire)) {
+        if (__bLogDrain())
+            continue;
+
+        // The flag is raised before the queue is checked again, so a producer either sees it or
+        // its record is seen here.
+        atomic_store(&tAsync.bSleeping, true);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (!__bLogPending() && atomic_load(&tAsync.bRunning))
+            SDL_SemWait(tAsync.sdlWake);
+        atomic_store(&tAsync.bSleeping, false);
+    }
+
+    __bLogDrain();
+    return 0;
+}
+
+/* Releases the synchronization primitives of the logging thread. */
+static void __vLogAsyncDestroy(void) {
+    if (tAsync.sdlWake)
+        SDL_DestroySemaphore(tAsync.sdlWake);
+    if (tAsync.sdlFlushed)
+        SDL_DestroyCond(tAsync.sdlFlushed);
+    if (tAsync.sdlFlushLock)
+        SDL_DestroyMutex(tAsync.sdlFlushLock);
+    tAsync.sdlWake = NULL;
+    tAsync.sdlFlushed = NULL;
+    tAsync.sdlFlushLock = NULL;
+}
+
+/* Starts the logging thread on the first message. Returns false if messages must go synchronously. */
+static bool __bLogAsyncStart(void) {
+    int iExpected = __lASYNC_STOPPED;
+
+    if (atomic_load_explicit(&tAsync.iState, memory_order_acquire) == __lASYNC_STARTED)
+        return true;
+
+    if (atomic_compare_exchange_strong(&tAsync.iState, &iExpected, __lASYNC_STARTING)) {
+        for (size_t i = 0; i < FEATHER_LOG_ASYNC_CAPACITY; ++i)
+            atomic_store_explicit(&tAsync.tCells[i].uSeq, i, memory_order_relaxed);
+
+        tAsync.sdlWake = SDL_CreateSemaphore(0);
+        tAsync.sdlFlushLock = SDL_CreateMutex();
+        tAsync.sdlFlushed = SDL_CreateCond();
+        atomic_store(&tAsync.bRunning, true);
+        if (tAsync.sdlWake && tAsync.sdlFlushLock && tAsync.sdlFlushed)
+            tAsync.sdlThread = SDL_CreateThread(__iLogThread, "feather_log", NULL);
+        if (!tAsync.sdlThread)
+            __vLogAsyncDestroy();
+        atomic_store_explicit(&tAsync.iState, tAsync.sdlThread ? __lASYNC_STARTED : __lASYNC_STOPPED, memory_order_release);
+        return tAsync.sdlThread != NULL;
+    }
+
+    // Another thread is starting the logger right now.
+    while (atomic_load_explicit(&tAsync.iState, memory_order_acquire) == __lASYNC_STARTING)
+        SDL_Delay(0);
+    return atomic_load_explicit(&tAsync.iState, memory_order_acquire) == __lASYNC_STARTED;
+}
+
+/* Reserves a cell, fills it and publishes it. Returns false if the queue is full. */
+static bool __bLogEnqueue(int iLevel, const char *cFile, int iLine, const char *cFmt, va_list vaAp) {
+    size_t uPos = atomic_load_explicit(&tAsync.uEnqueue, memory_order_relaxed);
+    tLogCell *tCell;
+
+    for (;;) {
+        tCell = &tAsync.tCells[uPos & (FEATHER_LOG_ASYNC_CAPACITY - 1)];
+        size_t uSeq = atomic_load_explicit(&tCell->uSeq, memory_order_acquire);
+        intptr_t iDiff = (intptr_t)uSeq - (intptr_t)uPos;
+
+        if (iDiff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&tAsync.uEnqueue, &uPos, uPos + 1, 
+                        memory_order_relaxed, memory_order_relaxed))
+                break;
+        } else if (iDiff < 0) {
+            return false;
+        } else {
+            uPos = atomic_load_explicit(&tAsync.uEnqueue, memory_order_relaxed);
+        }
+    }
+
+    tLogRecord *tRec = &tCell->tRec;
+    tRec->cFmt = cFmt;
+    tRec->cFile = cFile;
+    tRec->iLine = iLine;
+    tRec->iLevel = iLevel;
+    tRec->tTime = time(NULL);
+    tRec->uArgs = 0;
+    tRec->uStringsUsed = 0;
+    __vLogCapture(tRec, cFmt, vaAp);
+
+    atomic_store_explicit(&tCell->uSeq, uPos + 1, memory_order_release);
+    __vLogWake();
+    return true;
+}
+
+/* 
+ *  @brief - chooses what happens with messages when the asynchronous queue is full.
+ */
+void __feather_log_set_full_policy(eLogFullPolicy ePolicy) {
+    tAsync.ePolicy = ePolicy;
+}
+
+/* 
+ *  @brief - waits until all queued messages are written.
+ */
+void __feather_log_flush(void) {
+    size_t uTarget;
+
+    // Callbacks logging from the logging thread itself can't wait for it.
+    if (atomic_load_explicit(&tAsync.iState, memory_order_acquire) != __lASYNC_STARTED || 
+            SDL_ThreadID() == tAsync.uThreadId)
+        return;
+
+    uTarget = atomic_load_explicit(&tAsync.uEnqueue, memory_order_acquire);
+    SDL_LockMutex(tAsync.sdlFlushLock);
+    while ((intptr_t)(atomic_load_explicit(&tAsync.uDequeue, memory_order_acquire) - uTarget) < 0) {
+        __vLogWake();
+        SDL_CondWait(tAsync.sdlFlushed, tAsync.sdlFlushLock);
+    }
+    SDL_UnlockMutex(tAsync.sdlFlushLock);
+}
+
+/* 
+ *  @brief - writes all queued messages and stops the logging thread.
+ *
+ *  Messages logged afterwards are written synchronously.
+ */
+void __feather_log_close(void) {
+    int iExpected = __lASYNC_STARTED;
+
+    if (SDL_ThreadID() == tAsync.uThreadId || 
+            !atomic_compare_exchange_strong(&tAsync.iState, &iExpected, __lASYNC_CLOSED))
+        return;
+
+    atomic_store(&tAsync.bRunning, false);
+    SDL_SemPost(tAsync.sdlWake);
+    SDL_WaitThread(tAsync.sdlThread, NULL);
+    tAsync.sdlThread = NULL;
+
+    // Records published while the thread was exiting.
+    __bLogDrain();
+    __vLogAsyncDestroy();
+}
+
+/* 
+ *  @brief - Performs the actual logging logic.
+ *
+ *  The caller only captures the arguments into the queue. Formatting, timestamps, callbacks and
+ *  writes are done by the logging thread.
+ */
+void __feather_log(int iLevel, const char *cFile, int iLine, const char *cFmt, ...) {
+    va_list vaAp;
+    bool bQueued = false;
+
+    va_start(vaAp, cFmt);
+    if (__bLogAsyncStart()) {
+        bQueued = __bLogEnqueue(iLevel, cFile, iLine, cFmt, vaAp);
+
+        while (!bQueued && tAsync.ePolicy == lBLOCK) {
+            SDL_Delay(0);
+            bQueued = __bLogEnqueue(iLevel, cFile, iLine, cFmt, vaAp);
+        }
+
+        if (!bQueued && tAsync.ePolicy == lDROP) {
+            atomic_fetch_add_explicit(&tAsync.uDropped, 1, memory_order_relaxed);
+            __vLogWake();
+            bQueued = true;
+        }
+    }
+
+    // Queue is full under the synchronous policy, or the thread couldn't be started.
+    if (!bQueued)
+        __vLogSync(iLevel, cFile, iLine, cFmt, vaAp);
+    va_end(vaAp);
+
+    // Fatal messages usually precede an exit, so they must not be lost.
+    if (iLevel == lFATAL)
+        __feather_log_flush();
+}
+
+#else
+
+/* 
+ *  @brief - chooses what happens with messages when the asynchronous queue is full.
+ */
+void __feather_log_set_full_policy(eLogFullPolicy ePolicy) {
+    (void)ePolicy;
+}
+
+/* 
+ *  @brief - waits until all queued messages are written.
+ */
+void __feather_log_flush(void) {}
+
+/* 
+ *  @brief - writes all queued messages and stops the logging thread.
+ */
+void __feather_log_close(void) {}
+
+/* 
+ *  @brief - Performs the actual logging logic.
+ */
+void __feather_log(int iLevel, const char *cFile, int iLine, const char *cFmt, ...) {
+    va_list vaAp;
+    va_start(vaAp, cFmt);
+    __vLogSync(iLevel, cFile, iLine, cFmt, vaAp);
+    va_end(vaAp);
+}
+
+#endif
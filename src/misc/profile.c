@@ -0,0 +1,219 @@
+/**************************************************************************************************
+ *  File: profile.c
+ *  Desc: Frame phase profiler. Durations of the input, update and render phases, as well as of each
+ *  layer and controller, are kept in fixed-size rings and summarized on request.
+ **************************************************************************************************
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ * */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <profile.h>
+#include <trace.h>
+#include <intrinsics.h>
+#include <log.h>
+
+#define __PROFILE_MASK (FEATHER_PROFILE_MAX_SCOPES - 1)
+
+static struct {
+    tProfileScope tScopes[FEATHER_PROFILE_MAX_SCOPES];
+    uint32_t uOrder[FEATHER_PROFILE_MAX_SCOPES];
+    uint32_t uCount;
+    SDL_SpinLock iLock;
+} tProfiler;
+
+static int __iProfileCmp(const void *a, const void *b) {
+    uint64_t uA = *(const uint64_t*)a, uB = *(const uint64_t*)b;
+    return (uA > uB) - (uA < uB);
+}
+
+/* Nearest rank percentile of the sorted samples. */
+static uint64_t __uProfilePercentile(const uint64_t *uSorted, uint32_t uCount, uint32_t uPercent) {
+    uint32_t uRank = (uCount * uPercent + 99) / 100;
+    return uSorted[uRank ? uRank - 1 : 0];
+}
+
+/* 
+ *  @brief - returns the scope, registering it on the first call.
+ *
+ *  Returns NULL once FEATHER_PROFILE_MAX_SCOPES scopes exist.
+ * */
+tProfileScope* tProfileScopeGet(eProfileKind eKind, uintptr_t uKey, const char *sFmt, ...) {
+    uint32_t uSlot = (uint32_t)((uKey * 2654435761u) ^ eKind) & __PROFILE_MASK;
+    tProfileScope *tScope;
+    va_list vaAp;
+
+    SDL_AtomicLock(&tProfiler.iLock);
+    for (uint32_t i = 0; i < FEATHER_PROFILE_MAX_SCOPES; ++i, uSlot = (uSlot + 1) & __PROFILE_MASK) {
+        tScope = &tProfiler.tScopes[uSlot];
+        if (tScope->bUsed && tScope->eKind == eKind && tScope->uKey == uKey) {
+            SDL_AtomicUnlock(&tProfiler.iLock);
+            return tScope;
+        }
+        if (!tScope->bUsed)
+            break;
+    }
+
+    // Either a free slot was found, or the table is full.
+    if (tScope->bUsed) {
+        SDL_AtomicUnlock(&tProfiler.iLock);
+        return NULL;
+    }
+
+#if FEATHER_PROFILE
+    // Scopes only used for tracing keep no samples.
+    if ((tScope->uSamples = malloc(FEATHER_PROFILE_SAMPLES * sizeof(uint64_t))) == NULL) {
+        SDL_AtomicUnlock(&tProfiler.iLock);
+        return NULL;
+    }
+#endif
+
+    tScope->bUsed = true;
+    tScope->eKind = eKind;
+    tScope->uKey = uKey;
+    tScope->uHead = tScope->uCount = 0;
+    va_start(vaAp, sFmt);
+    vsnprintf(tScope->sName, sizeof(tScope->sName), sFmt, vaAp);
+    va_end(vaAp);
+    tProfiler.uOrder[tProfiler.uCount++] = uSlot;
+    SDL_AtomicUnlock(&tProfiler.iLock);
+
+    return tScope;
+}
+
+/* 
+ *  @brief - adds one duration in high-resolution ticks to the scope, overwriting the oldest one. NULL is ignored.
+ * */
+void vProfileRecord(tProfileScope *tScope, uint64_t uTicks) {
+    if (tScope == NULL || tScope->uSamples == NULL)
+        return;
+
+    // Layers running on the job system record concurrently with the main thread.
+    SDL_AtomicLock(&tProfiler.iLock);
+    tScope->uSamples[tScope->uHead] = uTicks;
+    tScope->uHead = (tScope->uHead + 1) % FEATHER_PROFILE_SAMPLES;
+    if (tScope->uCount < FEATHER_PROFILE_SAMPLES)
+        tScope->uCount++;
+    SDL_AtomicUnlock(&tProfiler.iLock);
+}
+
+/* 
+ *  @brief - finishes one timed run of the scope, feeding the profiler and the trace. NULL is ignored.
+ * */
+void vProfileScopeEnd(tProfileScope *tScope, uint64_t uStart, uint64_t uEnd) {
+    static const char *sCategories[] = { "phase", "layer", "controller" };
+
+    if (tScope == NULL)
+        return;
+
+#if FEATHER_PROFILE
+    vProfileRecord(tScope, uEnd - uStart);
+#endif
+#if FEATHER_TRACE
+    vTraceComplete(sCategories[tScope->eKind], uStart, uEnd, "%s", tScope->sName);
+#endif
+#if !FEATHER_PROFILE && !FEATHER_TRACE
+    (void)sCategories;
+    (void)uStart;
+    (void)uEnd;
+#elif !FEATHER_TRACE
+    (void)sCategories;
+#endif
+}
+
+/* 
+ *  @brief - returns the amount of registered scopes.
+ * */
+uint32_t uProfileScopeCount(void) {
+    return tProfiler.uCount;
+}
+
+/* 
+ *  @brief - computes statistics of the i-th registered scope. Returns false if there is no such scope.
+ * */
+bool bProfileStatsAt(uint32_t i, tProfileStats *tStats) {
+    uint64_t uSorted[FEATHER_PROFILE_SAMPLES], uSum = 0;
+    double dTickMs = 1000. / SDL_GetPerformanceFrequency();
+    tProfileScope *tScope;
+    uint32_t uCount;
+
+    if (i >= tProfiler.uCount)
+        return false;
+
+    SDL_AtomicLock(&tProfiler.iLock);
+    tScope = &tProfiler.tScopes[tProfiler.uOrder[i]];
+    uCount = tScope->uCount;
+    if (uCount)
+        memcpy(uSorted, tScope->uSamples, uCount * sizeof(uint64_t));
+    SDL_AtomicUnlock(&tProfiler.iLock);
+
+    *tStats = (tProfileStats) { .sName = tScope->sName, .uSamples = uCount };
+    if (uCount == 0)
+        return true;
+
+    qsort(uSorted, uCount, sizeof(uint64_t), __iProfileCmp);
+    for (uint32_t j = 0; j < uCount; ++j)
+        uSum += uSorted[j];
+
+    tStats->dMin = uSorted[0] * dTickMs;
+    tStats->dAvg = (double)uSum / uCount * dTickMs;
+    tStats->dP95 = __uProfilePercentile(uSorted, uCount, 95) * dTickMs;
+    tStats->dP99 = __uProfilePercentile(uSorted, uCount, 99) * dTickMs;
+    tStats->dMax = uSorted[uCount - 1] * dTickMs;
+    return true;
+}
+
+/* 
+ *  @brief - computes statistics of the scope with the provided name. Returns false if there is no such scope.
+ * */
+bool bProfileStats(const char *sName, tProfileStats *tStats) {
+    for (uint32_t i = 0; i < tProfiler.uCount; ++i)
+        if (strcmp(tProfiler.tScopes[tProfiler.uOrder[i]].sName, sName) == 0)
+            return bProfileStatsAt(i, tStats);
+
+    return false;
+}
+
+/* 
+ *  @brief - logs statistics of all scopes, which have samples.
+ * */
+void vProfileLogStats(void) {
+    tProfileStats tStats;
+
+    for (uint32_t i = 0; i < tProfiler.uCount; ++i)
+        if (bProfileStatsAt(i, &tStats) && tStats.uSamples)
+            vFeatherLogInfo("Profile <%s>: min %.3f avg %.3f p95 %.3f p99 %.3f max %.3f ms over %u samples.",
+                    tStats.sName, tStats.dMin, tStats.dAvg, tStats.dP95, tStats.dP99, tStats.dMax, tStats.uSamples);
+}
+
+/* 
+ *  @brief - drops all scopes and their samples.
+ * */
+void vProfileReset(void) {
+    SDL_AtomicLock(&tProfiler.iLock);
+    for (uint32_t i = 0; i < FEATHER_PROFILE_MAX_SCOPES; ++i)
+        free(tProfiler.tScopes[i].uSamples);
+    memset(tProfiler.tScopes, 0, sizeof(tProfiler.tScopes));
+    tProfiler.uCount = 0;
+    SDL_AtomicUnlock(&tProfiler.iLock);
+}
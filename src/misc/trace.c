@@ -0,0 +1,178 @@
+/**************************************************************************************************
+ *  File: trace.c
+ *  Desc: Trace writer. Timed scopes are recorded into per-thread buffers and written out as a Chrome
+ *  trace-event JSON file, which can be opened by chrome://tracing or Perfetto.
+ **************************************************************************************************
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ * */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <trace.h>
+#include <intrinsics.h>
+#include <log.h>
+
+// CMake strips the quotes of string options, so the trace file path arrives as bare tokens.
+#define __TRACE_STR(x) #x
+#define __TRACE_XSTR(x) __TRACE_STR(x)
+#define __TRACE_FILE __TRACE_XSTR(FEATHER_TRACE_FILE)
+
+static struct {
+    tTraceBuffer *tBuffers;
+    SDL_SpinLock iLock;
+    FILE *fOut;
+    bool bWritten;
+} tTracer;
+
+/* Buffer of the calling thread, registered with it's first event. */
+static _Thread_local tTraceBuffer *__tTraceLocal = NULL;
+
+static tTraceBuffer* __tTraceRegister(void) {
+    tTraceBuffer *tBuf = calloc(1, sizeof(tTraceBuffer));
+    if (tBuf == NULL)
+        return NULL;
+
+    tBuf->tEvents = malloc(FEATHER_TRACE_BUFFER_EVENTS * sizeof(tTraceEvent));
+    if (tBuf->tEvents == NULL) {
+        free(tBuf);
+        return NULL;
+    }
+    tBuf->uThread = SDL_ThreadID();
+
+    SDL_AtomicLock(&tTracer.iLock);
+    tBuf->tNext = tTracer.tBuffers;
+    tTracer.tBuffers = tBuf;
+    SDL_AtomicUnlock(&tTracer.iLock);
+
+    return tBuf;
+}
+
+/* Writes the string with JSON escaping, since names may hold paths. */
+static void __vTraceWriteString(FILE *fOut, const char *sStr) {
+    fputc('"', fOut);
+    for (; *sStr; ++sStr) {
+        if (*sStr == '"' || *sStr == '\\')
+            fputc('\\', fOut);
+        if ((unsigned char)*sStr >= 0x20)
+            fputc(*sStr, fOut);
+    }
+    fputc('"', fOut);
+}
+
+/* 
+ *  @brief - records a complete event into the calling thread's buffer.
+ *
+ *  @sCat       - category of the event. Must be a static string.
+ *  @uStart     - high-resolution tick when the event began.
+ *  @uEnd       - high-resolution tick when the event ended.
+ *  @sFmt       - printf format of the event's name.
+ * */
+void vTraceComplete(const char *sCat, uint64_t uStart, uint64_t uEnd, const char *sFmt, ...) {
+    tTraceBuffer *tBuf = __tTraceLocal;
+    va_list vaAp;
+
+    if (tBuf == NULL && (tBuf = __tTraceLocal = __tTraceRegister()) == NULL)
+        return;
+
+    SDL_AtomicLock(&tBuf->iLock);
+    if (tBuf->uCount == FEATHER_TRACE_BUFFER_EVENTS) {
+        tBuf->uDropped++;
+    } else {
+        tTraceEvent *tEv = &tBuf->tEvents[tBuf->uCount++];
+        tEv->sCat = sCat;
+        tEv->uStart = uStart;
+        tEv->uEnd = uEnd;
+        va_start(vaAp, sFmt);
+        vsnprintf(tEv->sName, sizeof(tEv->sName), sFmt, vaAp);
+        va_end(vaAp);
+    }
+    SDL_AtomicUnlock(&tBuf->iLock);
+}
+
+/* 
+ *  @brief - writes all recorded events to FEATHER_TRACE_FILE and empties the buffers.
+ *
+ *  The file is created by the first flush. Can be called at any time, e.g. right after a frame spike.
+ * */
+void vTraceFlush(void) {
+    double dTickUs = 1000000. / SDL_GetPerformanceFrequency();
+
+    SDL_AtomicLock(&tTracer.iLock);
+    if (tTracer.fOut == NULL) {
+        tTracer.fOut = fopen(__TRACE_FILE, "w");
+        if (tTracer.fOut == NULL) {
+            SDL_AtomicUnlock(&tTracer.iLock);
+            vFeatherLogError("Unable to open the trace file: %s", __TRACE_FILE);
+            return;
+        }
+        fputs("[\n", tTracer.fOut);
+    }
+
+    for (tTraceBuffer *tBuf = tTracer.tBuffers; tBuf != NULL; tBuf = tBuf->tNext) {
+        SDL_AtomicLock(&tBuf->iLock);
+        for (uint32_t i = 0; i < tBuf->uCount; ++i) {
+            tTraceEvent *tEv = &tBuf->tEvents[i];
+
+            fputs(tTracer.bWritten ? ",\n{\"name\":" : "{\"name\":", tTracer.fOut);
+            __vTraceWriteString(tTracer.fOut, tEv->sName);
+            fprintf(tTracer.fOut, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%lu}",
+                    tEv->sCat, tEv->uStart * dTickUs, (tEv->uEnd - tEv->uStart) * dTickUs, tBuf->uThread);
+            tTracer.bWritten = true;
+        }
+
+        if (tBuf->uDropped)
+            vFeatherLogWarn("Trace buffer of thread %lu was full, %u events were dropped.", tBuf->uThread, tBuf->uDropped);
+        tBuf->uCount = tBuf->uDropped = 0;
+        SDL_AtomicUnlock(&tBuf->iLock);
+    }
+
+    fflush(tTracer.fOut);
+    SDL_AtomicUnlock(&tTracer.iLock);
+}
+
+/* 
+ *  @brief - flushes the remaining events, finishes the JSON file and frees all buffers.
+ * */
+void vTraceClose(void) {
+    tTraceBuffer *tNext;
+
+    vTraceFlush();
+
+    SDL_AtomicLock(&tTracer.iLock);
+    if (tTracer.fOut != NULL) {
+        fputs("\n]\n", tTracer.fOut);
+        fclose(tTracer.fOut);
+        vFeatherLogInfo("Trace written to: %s", __TRACE_FILE);
+    }
+
+    for (tTraceBuffer *tBuf = tTracer.tBuffers; tBuf != NULL; tBuf = tNext) {
+        tNext = tBuf->tNext;
+        free(tBuf->tEvents);
+        free(tBuf);
+    }
+
+    tTracer.tBuffers = NULL;
+    tTracer.fOut = NULL;
+    tTracer.bWritten = false;
+    __tTraceLocal = NULL;
+    SDL_AtomicUnlock(&tTracer.iLock);
+}
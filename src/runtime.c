@@ -26,15 +26,122 @@
 
 #include "layer.h"
 #include <time.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <tllist.h>
 
 #include <log.h>
 #include <runtime.h>
+#include <physics.h>
 #include <intrinsics.h>
 #include <err.h>
+#include <profile.h>
+#include <trace.h>
 
 #ifndef __EMSCRIPTEN__
+/* 
+ *  Headless loop. Each frame advances the virtual clock by exactly one update step, so the run does not
+ *  depend on the machine's speed. Reports the throughput and exits once all requested frames are done.
+ * */
+static tEngineError __errFeatherHeadlessLoop(tRuntime *tRun) {
+    uint64_t uStart = SDL_GetPerformanceCounter();
+    uint32_t uFrame;
+    tEngineError errResult;
+
+    vFeatherLogInfo("Entering the headless loop. Frames: %u", tRun->uHeadlessFrames);
+
+    for (uFrame = 0; tRun->uHeadlessFrames == 0 || uFrame < tRun->uHeadlessFrames; ++uFrame) {
+        errResult = errEngineInputHandle(tRun);
+        if (errResult) return errResult;
+
+        vSchedulerAdvanceMs(FEATHER_MS_PER_UPDATE);
+        errResult = errEngineUpdateHandle(tRun);
+        if (errResult) return errResult;
+
+        errResult = errEngineRenderHandle(tRun);
+        if (errResult) return errResult;
+    }
+
+    double dSeconds = (double)(SDL_GetPerformanceCounter() - uStart) / SDL_GetPerformanceFrequency();
+    vFeatherLogInfo("Headless run finished: %u frames in %.3f s (%.1f frames/s).", 
+            uFrame, dSeconds, dSeconds > 0. ? uFrame / dSeconds : 0.);
+
+    vFeatherExit(0, tRun);
+    return 0;
+}
+
+#if FEATHER_PRECISE_LOOP
+/* Sleeps for the most of the time until the deadline and spins for the rest, since SDL_Delay is too coarse. */
+static void __vFeatherPaceFrame(uint64_t uDeadline, uint64_t uFreq) {
+    uint64_t uNow = SDL_GetPerformanceCounter();
+    uint64_t uSpin = uFreq * FEATHER_SPIN_THRESHOLD_US / 1000000;
+
+    if (uNow + uSpin < uDeadline)
+        SDL_Delay((uint32_t)((uDeadline - uNow - uSpin) * 1000 / uFreq));
+
+    while (SDL_GetPerformanceCounter() < uDeadline)
+        ;
+}
+
+/* 
+ *  @brief - main engine loop. Schedules all layers within the current scene.
+ *
+ *  Main/game loop which handles all operations within the chosen scene. The full workflow can be interpreted
+ *  as so:
+ *  - Processing input (I/O);
+ *  - Main program update (Schedules all layers with internal scheduler/computes physics);
+ *  - Renders the picture;
+ *
+ *  If some fatal error occurs, it will be thrown back as 'tEngineError'.
+ * */
+tEngineError errMainLoop(tRuntime *tRun) {
+    uint64_t uFreq, uStep, uCurrent, uLast, uDelay = 0;
+    uint32_t uSteps;
+    tEngineError errResult;
+
+    errResult = errEngineInit(tRun);
+    if (errResult) return errResult;
+
+    if (tRun->bHeadless)
+        return __errFeatherHeadlessLoop(tRun);
+
+    vFeatherLogInfo("Entering the main loop. MS_PER_UPDATE: %d", FEATHER_MS_PER_UPDATE);
+
+    uFreq = SDL_GetPerformanceFrequency();
+    uStep = uFreq * FEATHER_MS_PER_UPDATE / 1000;
+    uLast = SDL_GetPerformanceCounter();
+    for (;;) {
+        uCurrent = SDL_GetPerformanceCounter();
+        uDelay += uCurrent - uLast;
+        uLast = uCurrent;
+
+        errResult = errEngineInputHandle(tRun);
+        if (errResult) return errResult;
+
+        // Updating the game for certain amount of time passed, but never more than the step limit.
+        for (uSteps = 0; uDelay >= uStep && uSteps < FEATHER_MAX_UPDATE_STEPS; ++uSteps) {
+            errResult = errEngineUpdateHandle(tRun);
+            if (errResult) return errResult;
+            uDelay -= uStep;
+        }
+
+        // Dropping the time that can't be caught up, so a stall doesn't spiral into longer frames.
+        if (uDelay >= uStep)
+            uDelay %= uStep;
+        tRun->dAlpha = (double)uDelay / uStep;
+
+        errResult = errEngineRenderHandle(tRun);
+        if (errResult) return errResult;
+
+#if FEATHER_FPS_UNLIMITED == false
+        if (tRun->uFps)
+            __vFeatherPaceFrame(uCurrent + uFreq / tRun->uFps, uFreq);
+#endif
+    }
+
+    return 0;
+}
+#else
 /* 
  *  @brief - main engine loop. Schedules all layers within the current scene.
  *
@@ -53,6 +160,9 @@ tEngineError errMainLoop(tRuntime *tRun) {
     errResult = errEngineInit(tRun);
     if (errResult) return errResult;
 
+    if (tRun->bHeadless)
+        return __errFeatherHeadlessLoop(tRun);
+
     vFeatherLogInfo("Entering the main loop. MS_PER_UPDATE: %d", FEATHER_MS_PER_UPDATE);
 
     tLast = SDL_GetTicks();
@@ -83,6 +193,7 @@ tEngineError errMainLoop(tRuntime *tRun) {
 
     return 0;
 }
+#endif
 #else
 
 typedef struct {
@@ -144,7 +255,40 @@ tEngineError errEmscriptenPreloop(tRuntime *tRun) {
 
 #endif
 
+#if FEATHER_RENDER_THREAD
+static void __vFeatherDeferTextureDestroy(void *vRender, SDL_Texture *sdlTexture) {
+    vRenderThreadDestroyTexture(vRender, sdlTexture);
+}
+#endif
+
+/* Destroys all textures of the runtime. Runs on the thread using the renderer. */
+static void __vFeatherFreeTextures(void *vRun) {
+    tRuntime *tRun = vRun;
+    vTextureCacheFree(&tRun->tTextures);
+    vGlyphCacheFree(&tRun->tGlyphs);
+}
+
+/* Dummy drivers need neither a display nor an audio device. Only picked up when SDL's subsystems are started. */
+static void __vFeatherUseHeadless(void) {
+    SDL_setenv("SDL_VIDEODRIVER", "dummy", true);
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", true);
+    vSchedulerUseVirtualClock();
+}
+
 tEngineError errEngineInit(tRuntime *tRun) { 
+    bool bHeadless;
+
+    // Frame count within the environment turns any application into a headless benchmark.
+    const char *sFrames = SDL_getenv("FEATHER_HEADLESS_FRAMES");
+    if (sFrames != NULL) {
+        tRun->bHeadless = true;
+        tRun->uHeadlessFrames = (uint32_t)strtoul(sFrames, NULL, 10);
+    }
+
+    bHeadless = tRun->bHeadless;
+    if (bHeadless)
+        __vFeatherUseHeadless();
+
     // SDL environment initialization part.
     if (SDL_Init( FEATHER_SDL_INIT ) < 0) {
         vFeatherLogFatal("Unable to load SDL environment: %s", SDL_GetError());
@@ -171,6 +315,27 @@ tEngineError errEngineInit(tRuntime *tRun) {
         vRuntimeConfig(tRun); // This function shall be provided by user.
     else
         vFeatherLogWarn("Runtime configuration not provided. Default configuration will be used.");
+
+    // Headless mode chosen by the configuration restarts the display and audio with the dummy drivers.
+    if (tRun->bHeadless && !bHeadless) {
+        Mix_CloseAudio();
+        SDL_QuitSubSystem(SDL_INIT_VIDEO | SDL_INIT_AUDIO);
+        __vFeatherUseHeadless();
+
+        if (SDL_InitSubSystem(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
+            vFeatherLogFatal("Unable to restart SDL with headless drivers: %s", SDL_GetError());
+            return -errSDL_ERR;
+        }
+
+        if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) < 0) {
+            vFeatherLogFatal("Unable to open SDL audio mixer: %s", Mix_GetError());
+            return -errSDL_ERR;
+        }
+    } else if (!tRun->bHeadless && bHeadless) {
+        // Drivers and the virtual clock are already in use, so the run stays headless as a whole.
+        vFeatherLogWarn("Headless mode can't be left within 'vRuntimeConfig'. Runtime will stay headless.");
+        tRun->bHeadless = true;
+    }
  
     // Without a single scene, runtime shall abort.
     if (tRun->sScene == NULL) 
@@ -190,7 +355,25 @@ tEngineError errEngineInit(tRuntime *tRun) {
     if (tRun->wRunWindow == NULL)
         return -errSDL_ERR;
 
-    tRun->sdlRenderer = SDL_CreateRenderer(tRun->wRunWindow, -1, SDL_RENDERER_ACCELERATED);
+    uint32_t uRendFlags = tRun->bHeadless ? SDL_RENDERER_SOFTWARE : SDL_RENDERER_ACCELERATED;
+
+#if FEATHER_RENDER_THREAD
+    // The renderer is created by the render thread, so it's context is only ever used from that thread.
+    tRun->tRender = tRenderThreadCreate(tRun->wRunWindow, uRendFlags);
+    if (tRun->tRender != NULL) {
+        tRun->sdlRenderer = tRun->tRender->sdlRenderer;
+
+        // Textures released by the cache may still be drawn by the render thread, so their destruction is deferred.
+        tRun->tTextures.fDestroy = __vFeatherDeferTextureDestroy;
+        tRun->tTextures.vDestroyCtx = tRun->tRender;
+        tRun->tGlyphs.fDestroy = __vFeatherDeferTextureDestroy;
+        tRun->tGlyphs.vDestroyCtx = tRun->tRender;
+    }
+#endif
+
+    // Without a render thread, frames are drawn by the main thread.
+    if (tRun->sdlRenderer == NULL)
+        tRun->sdlRenderer = SDL_CreateRenderer(tRun->wRunWindow, -1, uRendFlags);
 
     if (tRun->sdlRenderer == NULL)
         return -errSDL_ERR;
@@ -222,75 +405,187 @@ tEngineError errEngineInit(tRuntime *tRun) {
  *  state after the swap, so they must be reset manually before calling this function.
  * */
 void vRuntimeSwapScene(tRuntime *tRun, tScene *tSc) {
+    FEATHER_TRACE_BEGIN(uStart);
     tRun->sScene = tSc;
     tll_sort(tRun->sScene->lLayers, bLayerCmp);
+    FEATHER_TRACE_END(uStart, "scene", "vRuntimeSwapScene %s", tSc->sName);
 }
 
 tEngineError errEngineInputHandle(tRuntime *tRun) {
     //vFeatherLogDebug("Entering the input handler function");
     SDL_Event sdlEvent;
+    FEATHER_PROFILE_BEGIN(uStart);
+
+    // Mouse targets follow their rects once per frame, so picking doesn't walk all of them.
+    vMouseIndexRefresh(&tRun->sScene->tMouseTargets, &tRun->sScene->tRects);
 
     while (SDL_PollEvent( &sdlEvent )) {
         switch (sdlEvent.type) {
             case SDL_QUIT:
                 vFeatherExit(0, tRun);
-            default:
-                // Marking all handler function to invoke on update.
-                tll_foreach(tRun->sScene->lControllers, c) {
-                    if (!c->item.invoke) {
-                        c->item.invoke = c->item.sdlEventType == sdlEvent.type;
-                        c->item.sdlEvent = sdlEvent;
-                    }
-                }
+            default: {
+                // Queueing the event for all handler functions of this event type.
+                tControllerBucket *tBucket = tControllerIndexGet(&tRun->sScene->tCtrlIndex, sdlEvent.type);
+                if (tBucket == NULL)
+                    break;
+
+                for (uint32_t i = 0; i < tBucket->uCount; ++i)
+                    if (bControllerPushEvent(tBucket->tCtrls[i], &sdlEvent))
+                        tBucket->tCtrls[i]->invoke = true;
+            }
         }
     }
 
+    FEATHER_PROFILE_END(uStart, PROFILE_PHASE, PHASE_INPUT, "input");
     return 0;
 }
 
+/* Layer run by the current worker thread. Concurrent layers can't share the scene's current layer. */
+static _Thread_local tLayer *__tFeatherWorkerLayer = NULL;
+
+static void __vFeatherRunLayerJob(void *vCtx, void *vArg) {
+    FEATHER_PROFILE_BEGIN(uStart);
+    __tFeatherWorkerLayer = (tLayer*)vArg;
+    __tFeatherWorkerLayer->fRun(vCtx);
+    FEATHER_PROFILE_END(uStart, PROFILE_LAYER, __tFeatherWorkerLayer->sName, "layer %s", __tFeatherWorkerLayer->sName);
+    __tFeatherWorkerLayer = NULL;
+}
+
+/* Runs all queued layers, concurrently if there is more than one. */
+static void __vFeatherRunLayerGraph(tRuntime *tRun) {
+    if (tRun->tLayerGraph.uCount == 0)
+        return;
+
+    if (tRun->tLayerGraph.uCount > 1 && tRun->tJobs == NULL)
+        tRun->tJobs = tJobSystemCreate(FEATHER_JOB_WORKERS);
+
+    tRun->tLayerGraph.vCtx = tRun;
+    vJobGraphRun(tRun->tJobs, &tRun->tLayerGraph);
+    vJobGraphClear(&tRun->tLayerGraph);
+}
+
+/* Adds the layer to the graph, after all queued layers it conflicts with. */
+static void __vFeatherQueueLayer(tRuntime *tRun, tLayer *tLr) {
+    tJobGraph *tGraph = &tRun->tLayerGraph;
+    uint32_t uJob = uJobGraphAdd(tGraph, __vFeatherRunLayerJob, tLr);
+
+    if (uJob == UINT32_MAX) {
+        __vFeatherRunLayerGraph(tRun);
+        __vFeatherRunLayerJob(tRun, tLr);
+        return;
+    }
+
+    for (uint32_t i = 0; i < uJob; ++i) {
+        tLayer *tPrev = (tLayer*)tGraph->tNodes[i].vArg;
+        if (!((tPrev->uWrites & (tLr->uReads | tLr->uWrites)) || (tPrev->uReads & tLr->uWrites)))
+            continue;
+
+        // Without the dependency the layer could race with a conflicting one, so it runs after all queued layers.
+        if (!bJobGraphDepend(tGraph, i, uJob)) {
+            vJobGraphPop(tGraph);
+            __vFeatherRunLayerGraph(tRun);
+            __vFeatherRunLayerJob(tRun, tLr);
+            return;
+        }
+    }
+}
+
 tEngineError errEngineUpdateHandle(tRuntime *tRun) {
     uint32_t uCtrlId = 0, uLayerId = 0;
     //vFeatherLogDebug("Entering the update function");
-    
+    FEATHER_PROFILE_BEGIN(uStart);
+
+    // All physical bodies are stepped at once.
+    if (tRun->sScene->tPhysics != NULL) {
+        FEATHER_PROFILE_BEGIN(uPhysicsStart);
+        vPhysicsWorldStep(tRun->sScene->tPhysics);
+        FEATHER_PROFILE_END(uPhysicsStart, PROFILE_PHASE, PHASE_PHYSICS, "physics");
+    }
+
     // Running all controller handler functions.
     tll_foreach(tRun->sScene->lControllers, c) {
         if (c->item.invoke) {
-            if (c->item.uControllerLastCalled + c->item.uDelay < SDL_GetTicks()) {
+            if (c->item.uControllerLastCalled + c->item.uDelay < uSchedulerNowMs()) {
                 tRun->sScene->uCurrentRunningControllerId = uCtrlId;
                 c->item.invoke = false; // Controllers may invoke themselves.
+                FEATHER_PROFILE_BEGIN(uCtrlStart);
                 c->item.fHnd(tRun, (struct tController*) &c->item);
-                c->item.uControllerLastCalled = SDL_GetTicks();
+                FEATHER_PROFILE_END(uCtrlStart, PROFILE_CONTROLLER, c->item.uControllerID, "controller %u", c->item.uControllerID);
+                vControllerClearEvents(&c->item); // The whole batch is consumed by one call.
+                c->item.uControllerLastCalled = uSchedulerNowMs();
             }
         }
         ++uCtrlId;
     }
 
+    // Waking up layers and timer callbacks, which are due.
+    vSchedulerRun(&tRun->sScene->tTimers, tRun);
+
     // Iterating over each user defined layer and updating the application logic.
     tll_foreach(tRun->sScene->lLayers, l) {
         if (l->item.iPriority) {
-            tRun->sScene->uCurrentRunningLayerId = uLayerId;
-            l->item.fRun(tRun);
+            if (l->item.bParked) {
+                // Parked layers are skipped and keep their remaining runs.
+                ++uLayerId;
+                continue;
+            } else if (l->item.uReads | l->item.uWrites) {
+                __vFeatherQueueLayer(tRun, &l->item);
+            } else {
+                // Layers without declared resources are barriers for the concurrent ones.
+                __vFeatherRunLayerGraph(tRun);
+                tRun->sScene->uCurrentRunningLayerId = uLayerId;
+                tRun->sScene->tCurrentLayer = &l->item;
+                FEATHER_PROFILE_BEGIN(uLayerStart);
+                l->item.fRun(tRun);
+                FEATHER_PROFILE_END(uLayerStart, PROFILE_LAYER, l->item.sName, "layer %s", l->item.sName);
+            }
             ++uLayerId;
-        } else 
+        } else {
+            vSchedulerCancelLayer(&tRun->sScene->tTimers, &l->item);
             tll_remove(tRun->sScene->lLayers, l);
+            continue;
+        }
 
         if (l->item.iPriority < 0)
             l->item.iPriority++;
     } 
+    __vFeatherRunLayerGraph(tRun);
+    tRun->sScene->tCurrentLayer = NULL;
 
+    FEATHER_PROFILE_END(uStart, PROFILE_PHASE, PHASE_UPDATE, "update");
     return 0;
 }
 
 tEngineError errEngineRenderHandle(tRuntime *tRun) {
     //vFeatherLogDebug("Entering the rendering function with delay: %f", dDelay);
+    FEATHER_PROFILE_BEGIN(uStart);
+    vRectPoolSort(&tRun->sScene->tRects);
+
+    // Only recording the frame, it is drawn by the render thread while the next one is updated.
+    if (tRun->tRender != NULL) {
+        for (uint32_t i = 0; i < tRun->sScene->tRects.uCount; ++i)
+            vRenderThreadPushRect(tRun->tRender, tRectPoolAt(&tRun->sScene->tRects, i));
+        vRenderThreadSubmit(tRun->tRender);
+        FEATHER_PROFILE_END(uStart, PROFILE_PHASE, PHASE_RENDER, "render");
+        return 0;
+    }
+
     SDL_RenderClear(tRun->sdlRenderer);
 
+#if FEATHER_RENDER_BATCHING
+    // Rects are sorted by priority and texture, so consecutive rects with the same texture share one draw call.
+    tRun->tBatch.uDrawCalls = 0;
+    for (uint32_t i = 0; i < tRun->sScene->tRects.uCount; ++i)
+        vBatchPushRect(&tRun->tBatch, tRun->sdlRenderer, tRectPoolAt(&tRun->sScene->tRects, i));
+    vBatchFlush(&tRun->tBatch, tRun->sdlRenderer);
+#else
     // Drawing all rect objects to the screen.
-    tll_foreach(tRun->sScene->lRects, rect) {
-        vDrawRect(tRun, (tRect*)rect);
-    }
+    for (uint32_t i = 0; i < tRun->sScene->tRects.uCount; ++i)
+        vDrawRect(tRun, tRectPoolAt(&tRun->sScene->tRects, i));
+#endif
 
     SDL_RenderPresent(tRun->sdlRenderer);
+    FEATHER_PROFILE_END(uStart, PROFILE_PHASE, PHASE_RENDER, "render");
     return 0;
 }
 
@@ -299,9 +594,30 @@ tEngineError errEngineRenderHandle(tRuntime *tRun) {
  * */
 void vFeatherExit(tEngineError tStatus, tRuntime *tRun) {
     vFeatherLogInfo("Exiting...");
+    vControllerIndexFree(&tRun->sScene->tCtrlIndex);
+    vMouseIndexFree(&tRun->sScene->tMouseTargets);
+    tll_foreach(tRun->sScene->lControllers, c)
+        vControllerFreeEvents(&c->item);
     tll_free(tRun->sScene->lControllers);
     tll_free(tRun->sScene->lLayers);
-    tll_free(tRun->sScene->lRects);
+    vRectPoolFree(&tRun->sScene->tRects);
+    vPhysicsWorldFree(tRun->sScene->tPhysics);
+    vSchedulerFree(&tRun->sScene->tTimers);
+    vJobSystemFree(tRun->tJobs);
+    vJobGraphFree(&tRun->tLayerGraph);
+    vRenderThreadCall(tRun->tRender, __vFeatherFreeTextures, tRun);
+    vRenderThreadFree(tRun->tRender);
+    vBatchFree(&tRun->tBatch);
+#if FEATHER_TRACE
+    vTraceClose();
+#endif
+#if FEATHER_PROFILE
+    vProfileLogStats();
+#endif
+#if FEATHER_PROFILE || FEATHER_TRACE
+    vProfileReset();
+#endif
+    vFeatherLogClose();
 
     SDL_Quit();
     exit(tStatus);
@@ -323,6 +639,20 @@ void vRuntimeGetWindowDimensions(tRuntime *tRun, int *w, int *h) {
 }
 
 
+/* Layers usually sleep on themselves, so the running layer is checked before walking the list. */
+static tLayer* __tFeatherFindLayer(tRuntime *tRun, const char *sLayerName) {
+    if (__tFeatherWorkerLayer != NULL && __tFeatherWorkerLayer->sName == sLayerName)
+        return __tFeatherWorkerLayer;
+    if (tRun->sScene->tCurrentLayer != NULL && tRun->sScene->tCurrentLayer->sName == sLayerName)
+        return tRun->sScene->tCurrentLayer;
+
+    tll_foreach(tRun->sScene->lLayers, it)
+        if (it->item.sName == sLayerName)
+            return &it->item;
+
+    return NULL;
+}
+
 /* 
  *  @brief - sleep for a certain amount of milliseconds
  *
@@ -330,14 +660,14 @@ void vRuntimeGetWindowDimensions(tRuntime *tRun, int *w, int *h) {
  *  within the layers.
  * */
 void __vFeatherSleepLayerMs(tRuntime *tRun, const char *sLayerName, uint32_t ms) {
-    tll_foreach(tRun->sScene->lLayers, it) {
-        if (it->item.sName == sLayerName) {
-            it->item.uLastSleep = SDL_GetTicks() + ms;
-            return;
-        }
+    tLayer *tLr = __tFeatherFindLayer(tRun, sLayerName);
+
+    if (tLr == NULL) {
+        vFeatherLogWarn("Unable to sleep on layer: %s. Layer does not exist.", sLayerName);
+        return;
     }
 
-    vFeatherLogWarn("Unable to sleep on layer: %s. Layer does not exist.", sLayerName);
+    tLr->uLastSleep = uSchedulerNowMs() + ms;
 }
 
 /* 
@@ -346,21 +676,21 @@ void __vFeatherSleepLayerMs(tRuntime *tRun, const char *sLayerName, uint32_t ms)
  *  This function also resets the sleeping amount.
  * */
 int __vFeatherCheckLayerSleepMs(tRuntime *tRun, const char *sLayerName) {
-    tll_foreach(tRun->sScene->lLayers, it) {
-        if (it->item.sName == sLayerName) {
-            if (it->item.uLastSleep == 0) {
-                return 0;
-            } else if (SDL_GetTicks() > it->item.uLastSleep) {
-                it->item.uLastSleep = 0;
-                return -1;
-            } else {
-                return 1;
-            }
-        }
+    tLayer *tLr = __tFeatherFindLayer(tRun, sLayerName);
+
+    if (tLr == NULL) {
+        vFeatherLogWarn("Unable to check sleep on layer: %s. Layer does not exist.", sLayerName);
+        return -1;
     }
 
-    vFeatherLogWarn("Unable to check sleep on layer: %s. Layer does not exist.", sLayerName);
-    return -1;
+    if (tLr->uLastSleep == 0) {
+        return 0;
+    } else if (uSchedulerNowMs() > tLr->uLastSleep) {
+        tLr->uLastSleep = 0;
+        return -1;
+    } else {
+        return 1;
+    }
 }
 
 /* 
@@ -369,16 +699,7 @@ int __vFeatherCheckLayerSleepMs(tRuntime *tRun, const char *sLayerName) {
  *  NULL is returned if something will go wrong, even though it rather imposible...
  * */
 tLayer* tRuntimeGetCurrentLayer(tRuntime *tRun) {
-    uint32_t uLayerID = 0;
-    tLayer *tLr = NULL;
-
-    tll_foreach(tRun->sScene->lLayers, tLayer) {
-        if (uLayerID == tRun->sScene->uCurrentRunningLayerId) {
-            tLr = &tLayer->item;
-            break;
-        }
-        ++uLayerID;
-    }
+    tLayer *tLr = __tFeatherWorkerLayer ? __tFeatherWorkerLayer : tRun->sScene->tCurrentLayer;
 
     if (tLr == NULL)
         vFeatherLogError("Internal error occured. Unable to retrieve currently running layer.");
@@ -386,6 +707,63 @@ tLayer* tRuntimeGetCurrentLayer(tRuntime *tRun) {
     return tLr;
 }
 
+/* 
+ *  @brief - parks the currently running layer, so it won't be run at all for the provided time.
+ *
+ *  Unlike the sleep clauses, which still run the layer on each tick, parked layers cost nothing
+ *  until their deadline within the scheduler is due.
+ * */
+void vFeatherParkThisLayerMs(tRuntime *tRun, uint32_t ms) {
+    tLayer *tLr = tRuntimeGetCurrentLayer(tRun);
+    if (tLr == NULL)
+        return;
+
+    vSchedulerCancelLayer(&tRun->sScene->tTimers, tLr);
+    tTimer tTm = { .uDeadline = uSchedulerNow() + uSchedulerTicksFromMs(ms), .tLr = tLr };
+    tLr->bParked = uSchedulerAdd(&tRun->sScene->tTimers, tTm) != 0;
+}
+
+/* 
+ *  @brief - parks the currently running layer for the provided amount of update ticks.
+ * */
+void vFeatherParkThisLayerTicks(tRuntime *tRun, uint32_t uTicks) {
+    tLayer *tLr = tRuntimeGetCurrentLayer(tRun);
+    if (tLr == NULL)
+        return;
+
+    vSchedulerCancelLayer(&tRun->sScene->tTimers, tLr);
+    tTimer tTm = { .uDeadline = tRun->sScene->tTimers.uTick + uTicks, .bTicks = true, .tLr = tLr };
+    tLr->bParked = uSchedulerAdd(&tRun->sScene->tTimers, tTm) != 0;
+}
+
+/* 
+ *  @brief - calls the function once after the provided amount of milliseconds.
+ *
+ *  Returns the timer's identifier, which can be used to cancel it, or zero on failure.
+ * */
+uint32_t uFeatherAfterMs(tRuntime *tRun, uint32_t ms, fTimerFn fFn, void *vUserData) {
+    tTimer tTm = { .uDeadline = uSchedulerNow() + uSchedulerTicksFromMs(ms), .fFn = fFn, .vUserData = vUserData };
+    return uSchedulerAdd(&tRun->sScene->tTimers, tTm);
+}
+
+/* 
+ *  @brief - calls the function repeatedly, each time the provided amount of milliseconds passes.
+ *
+ *  Returns the timer's identifier, which can be used to cancel it, or zero on failure.
+ * */
+uint32_t uFeatherEveryMs(tRuntime *tRun, uint32_t ms, fTimerFn fFn, void *vUserData) {
+    uint64_t uPeriod = uSchedulerTicksFromMs(ms ? ms : 1);
+    tTimer tTm = { .uDeadline = uSchedulerNow() + uPeriod, .uPeriod = uPeriod, .fFn = fFn, .vUserData = vUserData };
+    return uSchedulerAdd(&tRun->sScene->tTimers, tTm);
+}
+
+/* 
+ *  @brief - cancels the pending timer of the current scene. Returns false if no such timer is pending.
+ * */
+bool bFeatherCancelTimer(tRuntime *tRun, uint32_t uTimerId) {
+    return bSchedulerCancel(&tRun->sScene->tTimers, uTimerId);
+}
+
 
 /* 
  *  @brief - Removes any remained sleep time from the currently running layer.
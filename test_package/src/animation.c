@@ -63,12 +63,10 @@ FEATHER_LAYER(&Animation, 1, UpdateAnimation,
     vAnimateFrame(tRun, tAnimatedSprites, uAnimationId, 400);
 });
 
-FEATHER_LAYER(&Animation, 1, IncrementAnimationId,, {
-    tRuntime *tRun = tThisRuntime();
-
-    vFeatherSleepThisLayerMs(tRun, 2000) 
-        if (++uAnimationId >= 34)
-            uAnimationId = 0;
+FEATHER_COROUTINE(&Animation, 1, IncrementAnimationId,, {
+    vFeatherCoWaitMs(2000);
+    if (++uAnimationId >= 34)
+        uAnimationId = 0;
 });
 
 RUNTIME_CONFIGURE(cfg)
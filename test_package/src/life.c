@@ -38,7 +38,7 @@
 #define BLOCK_SIZE 15
 
 struct {
-    tRect tRcts[CANVAS_SIZE][CANVAS_SIZE];
+    tRect *tRcts[CANVAS_SIZE][CANVAS_SIZE];
     bool tBools[CANVAS_SIZE][CANVAS_SIZE];
 } tGameCanvas;
 
@@ -82,7 +82,6 @@ FEATHER_LAYER(&GoL, 1, GameOfLifeUpdate,,{
 void vRestartBoard(void *vRun, tController* tCtrl) {
     tRuntime* tRun = (tRuntime*)vRun;
     tContext2D tCtx = tContextInit();
-    tRect *tRct = NULL;
     tCtx.fScaleX = BLOCK_SIZE;
     tCtx.fScaleY = BLOCK_SIZE;
 
@@ -91,17 +90,16 @@ void vRestartBoard(void *vRun, tController* tCtrl) {
             tCtx.fX = i * BLOCK_SIZE;
             tCtx.fY = j * BLOCK_SIZE;
 
-            tRct = tInitRect(tRun, tCtx, 1, NULL);
+            // Cells are created once, restarting only recolors them.
+            if (tGameCanvas.tRcts[i][j] == NULL)
+                tGameCanvas.tRcts[i][j] = tInitRect(tRun, tCtx, 1, NULL);
             tGameCanvas.tBools[i][j] = false;
 
             if (rand() % 8 == 0) {
-                vChangeRectColor(tRun, tRct, (SDL_Color) { 255, 255, 255, 255 });
+                vChangeRectColor(tRun, tGameCanvas.tRcts[i][j], (SDL_Color) { 255, 255, 255, 255 });
                 tGameCanvas.tBools[i][j] = true;
             } else 
-                vChangeRectColor(tRun, tRct, (SDL_Color) { 0, 0, 0, 255 });
-
-
-            tGameCanvas.tRcts[i][j] = *tRct;
+                vChangeRectColor(tRun, tGameCanvas.tRcts[i][j], (SDL_Color) { 0, 0, 0, 255 });
         }
 }
 
@@ -130,7 +128,7 @@ void vGameOfLife(tRuntime *tRun, int i, int j) {
         // Rule 1: Any live cell with fewer than two live neighbours dies (underpopulation).
         // Rule 3: Any live cell with more than three live neighbours dies (overpopulation).
         if (uNeighb < 2 || uNeighb > 3) {
-            vChangeRectColor(tRun, &tGameCanvas.tRcts[i][j], (SDL_Color) {0, 0, 0, 255});
+            vChangeRectColor(tRun, tGameCanvas.tRcts[i][j], (SDL_Color) {0, 0, 0, 255});
             tGameCanvas.tBools[i][j] = false;
         }
         // Rule 2: Any live cell with two or three live neighbours lives on to the next generation.
@@ -138,7 +136,7 @@ void vGameOfLife(tRuntime *tRun, int i, int j) {
     } else {
         // Rule 4: Any dead cell with exactly three live neighbours becomes a live cell (reproduction).
         if (uNeighb == 3) {
-            vChangeRectColor(tRun, &tGameCanvas.tRcts[i][j], (SDL_Color) {255, 255, 255, 255});
+            vChangeRectColor(tRun, tGameCanvas.tRcts[i][j], (SDL_Color) {255, 255, 255, 255});
             tGameCanvas.tBools[i][j] = true;
         }
     }
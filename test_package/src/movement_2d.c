@@ -80,13 +80,14 @@ FEATHER_LAYER(&Menu, iPerformNTimes(1), MainMenuLayer,
 /* Small animation for main menu button */
 FEATHER_LAYER(&Menu, 1, MainMenuAnimate, bool flag, {
     tRuntime *tRun = tThisRuntime();
-    vFeatherSleepLayerMs(tRun, MainMenuAnimate, 1000) {
-        char *sMenuTexture = flag ? "assets/MainMenu1.jpg" : "assets/MainMenu2.jpg";
+    char *sMenuTexture = flag ? "assets/MainMenu1.jpg" : "assets/MainMenu2.jpg";
 
-        if (BackGround != NULL)
+    if (BackGround != NULL)
         vChangeRectTexture(tRun, BackGround, sMenuTexture);
-        flag = !flag;
-    }
+    flag = !flag;
+
+    // The whole layer is parked, so it is not run at all until the next swap.
+    vFeatherParkThisLayerMs(tRun, 1000);
 });
 
 // Adjusting the main menu image to fullscreen.
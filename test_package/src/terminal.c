@@ -55,31 +55,34 @@ FEATHER_LAYER(&Shell, iPerformNTimes(1), TerminalInit,
 
 void vHandleTextInput(void *vRun, tController *tCtrl) {
     tRuntime *tRun = (tRuntime*)vRun;
-    // Append the text input (captured as a string) to the text buffer
-    vTextAppend(tRun, &tTxt, tCtrl->sdlEvent.text.text);
+    // Append all text input of the frame (captured as strings) to the text buffer
+    for (uint32_t i = 0; i < tCtrl->uEventCount; ++i)
+        vTextAppend(tRun, &tTxt, tCtrl->sdlEvents[i].text.text);
 }
 
 void vHandleSpecialKeys(void *vRun, tController *tCtrl) {
     tRuntime *tRun = (tRuntime*)vRun;
     const char *cCmd;
 
-    switch (tCtrl->sdlEvent.key.keysym.sym) {
-        case SDLK_BACKSPACE:
-            vTextPopChar(tRun, &tTxt); // Remove the last character
-            break;
-        case SDLK_RETURN:
-        case SDLK_RETURN2:
-            // Move to the next line and execute the command
-            tCtx.fX = 0; 
-            tCtx.fY += tTxt.uFontSize;
-
-            // Reset the text buffer for the new prompt
-            tTxt = *tTextInit(tRun, &tTxt, " ", tCtx, "assets/FiraCode-Bold.ttf", 1);
-            cCmd = sTextClear(tRun, &tTxt);
-
-            // Retrieve and execute the command
-            vHandleCmd(tRun, cCmd);
-            break;
+    for (uint32_t i = 0; i < tCtrl->uEventCount; ++i) {
+        switch (tCtrl->sdlEvents[i].key.keysym.sym) {
+            case SDLK_BACKSPACE:
+                vTextPopChar(tRun, &tTxt); // Remove the last character
+                break;
+            case SDLK_RETURN:
+            case SDLK_RETURN2:
+                // Move to the next line and execute the command
+                tCtx.fX = 0; 
+                tCtx.fY += tTxt.uFontSize;
+
+                // Reset the text buffer for the new prompt
+                tTxt = *tTextInit(tRun, &tTxt, " ", tCtx, "assets/FiraCode-Bold.ttf", 1);
+                cCmd = sTextClear(tRun, &tTxt);
+
+                // Retrieve and execute the command
+                vHandleCmd(tRun, cCmd);
+                break;
+        }
     }
 }
 